@@ -0,0 +1,151 @@
+//
+//  commandLine.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "commandLine.hpp"
+#include <stdexcept>
+#include <iostream>
+
+namespace {
+
+// The value after a flag, as in --dt 0.01
+const char* takeValue(int argc, char** argv, int& i) {
+    if (i + 1 >= argc) {
+        throw std::runtime_error(std::string("Missing value after ") + argv[i]);
+    }
+    return argv[++i];
+}
+
+double parseDouble(const std::string& flag, const char* value) {
+    try {
+        size_t used;
+        double result = std::stod(value, &used);
+        if (used == std::string(value).size()) {
+            return result;
+        }
+    } catch (const std::exception&) {}
+    throw std::runtime_error("Expected a number after " + flag + ", got '" + value + "'");
+}
+
+long long parseInteger(const std::string& flag, const char* value) {
+    try {
+        size_t used;
+        long long result = std::stoll(value, &used);
+        if (used == std::string(value).size()) {
+            return result;
+        }
+    } catch (const std::exception&) {}
+    throw std::runtime_error("Expected an integer after " + flag + ", got '" + value + "'");
+}
+
+} // end anonymous namespace
+
+CommandLineOptions parseCommandLine(int argc, char** argv)
+{
+    CommandLineOptions options;
+    SimulationParameterOverrides& overrides = options.overrides;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        
+        if (flag == "-h" || flag == "--help") {
+            options.showHelp = true;
+        } else if (flag == "--mode") {
+            overrides.mode = static_cast<int>(parseInteger(flag, takeValue(argc, argv, i)));
+            if (*overrides.mode != 0 && *overrides.mode != 1) {
+                throw std::runtime_error("--mode must be 0 (single simulation) or 1 (simulation network)");
+            }
+        } else if (flag == "--graphics") {
+            overrides.graphicsOn = true;
+        } else if (flag == "--no-graphics") {
+            overrides.graphicsOn = false;
+        } else if (flag == "--bulk") {
+            overrides.bulkMode = true;
+            overrides.mode = 1;
+        } else if (flag == "--time") {
+            overrides.timeToRun = parseDouble(flag, takeValue(argc, argv, i));
+        } else if (flag == "--dt") {
+            overrides.dt = parseDouble(flag, takeValue(argc, argv, i));
+        } else if (flag == "--diffusion") {
+            overrides.diffusionCoefficient = parseDouble(flag, takeValue(argc, argv, i));
+        } else if (flag == "--iterations-per-frame") {
+            overrides.iterationsPerFrame = static_cast<int>(parseInteger(flag, takeValue(argc, argv, i)));
+        } else if (flag == "--first-passage") {
+            overrides.firstPassageJumps = true;
+        } else if (flag == "--no-first-passage") {
+            overrides.firstPassageJumps = false;
+        } else if (flag == "--first-passage-safety") {
+            overrides.firstPassageSafety = parseDouble(flag, takeValue(argc, argv, i));
+        } else if (flag == "--first-passage-max-steps") {
+            overrides.firstPassageMaxSteps = static_cast<int>(parseInteger(flag, takeValue(argc, argv, i)));
+        } else if (flag == "--config") {
+            options.networkConfigPath = takeValue(argc, argv, i);
+        } else if (flag == "--bulk-dir") {
+            options.bulkConfigDir = takeValue(argc, argv, i);
+        } else if (flag == "--bulk-output") {
+            options.bulkOutputDir = takeValue(argc, argv, i);
+        } else if (flag == "--concurrency") {
+            options.bulkConcurrency = static_cast<int>(parseInteger(flag, takeValue(argc, argv, i)));
+        } else if (flag == "--seed") {
+            options.bulkBaseSeed = static_cast<uint64_t>(parseInteger(flag, takeValue(argc, argv, i)));
+        } else if (flag == "--impulse-response") {
+            options.bulkImpulseResponse = true;
+        } else if (flag == "--expected-counts") {
+            options.resampleCounts = false;
+        } else if (flag == "--adjoint") {
+            options.adjoint = true;
+            overrides.mode = 1;
+        } else if (flag == "--adjoint-output") {
+            options.adjointOutputDir = takeValue(argc, argv, i);
+        } else if (flag == "--threads") {
+            options.networkThreadCount = static_cast<int>(parseInteger(flag, takeValue(argc, argv, i)));
+        } else {
+            throw std::runtime_error("Unknown option " + flag);
+        }
+    }
+    
+    if ((overrides.dt && *overrides.dt <= 0) || (overrides.timeToRun && *overrides.timeToRun <= 0)) {
+        throw std::runtime_error("--dt and --time must be positive");
+    }
+    if (overrides.iterationsPerFrame && *overrides.iterationsPerFrame <= 0) {
+        throw std::runtime_error("--iterations-per-frame must be positive");
+    }
+    if ((overrides.firstPassageSafety && *overrides.firstPassageSafety <= 0)
+        || (overrides.firstPassageMaxSteps && *overrides.firstPassageMaxSteps <= 0)) {
+        throw std::runtime_error("--first-passage-safety and --first-passage-max-steps must be positive");
+    }
+    
+    return options;
+}
+
+void printUsage(const char* programName)
+{
+    std::cout << "Usage: " << programName << " [options]\n"
+              << "Defaults come from src/config/config.h, a network YAML can change the simulation parameters\n"
+              << "in its simulation: section and the flags below override both.\n"
+              << "\n"
+              << "  --mode <0|1>                  0 for single simulation, 1 for simulation network\n"
+              << "  --graphics, --no-graphics     show or hide the simulation window\n"
+              << "  --bulk                        run every config of the bulk directory (implies --mode 1)\n"
+              << "  --time <seconds>              simulated time\n"
+              << "  --dt <seconds>                time step\n"
+              << "  --diffusion <m^2/s>           diffusion coefficient\n"
+              << "  --iterations-per-frame <n>    iterations between drawn frames\n"
+              << "  --first-passage, --no-first-passage\n"
+              << "                                let particles far from everything jump many steps at once\n"
+              << "  --first-passage-safety <n>    standard deviations of a jump's walk that must fit in its clearance\n"
+              << "  --first-passage-max-steps <n> longest jump, in time steps\n"
+              << "  --config <file>               network config (default config/network_config.yaml)\n"
+              << "  --bulk-dir <directory>        bulk configs (default config/bulkconfigs/)\n"
+              << "  --bulk-output <directory>     bulk outputs (default Output/BulkOutputs)\n"
+              << "  --concurrency <n>             networks run at once in bulk mode, 0 for one per hardware thread\n"
+              << "  --seed <n>                    base seed of bulk configs without their own seed\n"
+              << "  --impulse-response            bulk outputs from measured impulse responses instead of full runs\n"
+              << "  --expected-counts             with --impulse-response, write expected counts instead of Poisson ones\n"
+              << "  --threads <n>                 threads per network, 0 for one per hardware thread\n"
+              << "  --adjoint                     every receiver's response to emitters anywhere, from reverse-time runs\n"
+              << "  --adjoint-output <directory>  adjoint outputs (default Output/AdjointOutputs)\n";
+}
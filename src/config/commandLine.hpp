@@ -0,0 +1,36 @@
+//
+//  commandLine.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef commandLine_hpp
+#define commandLine_hpp
+
+#include <stdio.h>
+#include <string>
+#include <cstdint>
+#include <src/config/config.h>
+#include <src/config/simulationParameters.hpp>
+
+struct CommandLineOptions {
+    SimulationParameterOverrides overrides;
+    std::string networkConfigPath = "config/network_config.yaml";
+    std::string bulkConfigDir = "config/bulkconfigs/";
+    std::string bulkOutputDir = "Output/BulkOutputs";
+    int bulkConcurrency = BULK_CONCURRENCY;
+    uint64_t bulkBaseSeed = BULK_BASE_SEED;
+    bool bulkImpulseResponse = BULK_IMPULSE_RESPONSE;
+    bool resampleCounts = IMPULSE_RESPONSE_RESAMPLE;
+    int networkThreadCount = NETWORK_THREAD_COUNT;
+    bool adjoint = false; // run the network's adjoint instead of the network
+    std::string adjointOutputDir = "Output/AdjointOutputs";
+    bool showHelp = false;
+};
+
+// Throws std::runtime_error for unknown flags and bad values
+CommandLineOptions parseCommandLine(int argc, char** argv);
+void printUsage(const char* programName);
+
+#endif /* commandLine_hpp */
@@ -4,24 +4,59 @@
 #ifndef config_h
 #define config_h
 
+// The values below marked [default] are only defaults now, see src/config/simulationParameters.hpp:
+// a network YAML can change them in a simulation: section and command line flags (--help) override both.
+
 #define OUTPUT_RESULTS true
-#define GRAPHICS_ON true
+// Receiver counts as compact binary .rcv files (see src/output/receiverOutput.hpp) instead of comma separated .txt
+#define RECEIVER_OUTPUT_BINARY false
+// Receivers keep a list of the bins that got hits instead of an array with a bin for every iteration
+#define RECEIVER_SPARSE_COUNTS true
+// Iterations summed into one output bin, 1 keeps a count for every iteration
+#define RECEIVER_BIN_ITERATIONS 1
+#define GRAPHICS_ON true // [default]
 
 // 0 for single simulation
 // 1 for simulation network
 // If simulation network is chosen, applied boundary is automatically cylinder boundary
-#define MODE 1
-#define BULKMODE false
-
-#define TIME_TO_RUN 5000
-#define DT 0.01
-#define NUMBER_OF_ITERATIONS (int)(TIME_TO_RUN/DT)
-#define ITERATIONS_PER_FRAME 100
-
-#define D 7.94e-11 // diffusion coefficient
+#define MODE 1 // [default]
+#define BULKMODE false // [default]
+#define BULK_CONCURRENCY 0 // networks run at the same time in bulk mode, 0 for one per hardware thread
+#define BULK_BASE_SEED 0 // configs without a seed get one derived from this and their file name
+// Bulk runs synthesize receiver outputs from measured impulse responses instead of simulating every config
+// (see src/core/network/impulseResponse.hpp)
+#define BULK_IMPULSE_RESPONSE false // [default]
+#define IMPULSE_RESPONSE_PARTICLES 100000 // particles released to measure one emitter's responses
+#define IMPULSE_RESPONSE_RESAMPLE true // Poisson counts around the expected ones, false writes the expected counts [default]
+
+#define TIME_TO_RUN 5000 // [default]
+#define DT 0.01 // [default]
+#define NUMBER_OF_ITERATIONS (int)(TIME_TO_RUN/DT) // of the defaults, runs use SimulationParameters::getIterationCount()
+#define ITERATIONS_PER_FRAME 100 // [default]
+
+#define D 7.94e-11 // diffusion coefficient [default]
 
 #define GRAPHICS_ZOOM_MULTIPLIER 1e+02
 
 #define FLOW_VALUE 0.001
 
+// Threads used to step the pipes of a network, 0 for one per hardware thread, 1 to run serially
+#define NETWORK_THREAD_COUNT 0
+
+// Particles far from the wall, the pipe ends and every receiver skip many DT steps in one jump
+// (see src/core/kernels/firstPassage.hpp) [defaults]
+#define FIRST_PASSAGE_JUMPS false
+#define FIRST_PASSAGE_SAFETY 6.0 // standard deviations of the jump's walk that must fit in the clearance
+#define FIRST_PASSAGE_MAX_STEPS 4096 // longest jump, in DT steps
+
+// Adjoint runs (--adjoint): walkers released from every receiver under the reversed flow, tallied onto a grid of
+// candidate emitter positions in every pipe (see src/core/network/adjointResponse.hpp)
+#define ADJOINT_WALKERS 100000 // walkers released per receiver
+#define ADJOINT_RADIAL_CELLS 8 // rings of equal width per pipe
+#define ADJOINT_AXIAL_CELLS 64 // slices of equal length per pipe
+#define ADJOINT_BIN_ITERATIONS 100 // iterations per time bin of the tallies
+
+// Keep each network config's resolved network in <config>.msnc and load that while the config is unchanged
+#define NETWORK_CACHE true
+
 #endif /* config_h */
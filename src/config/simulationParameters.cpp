@@ -0,0 +1,22 @@
+//
+//  simulationParameters.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "simulationParameters.hpp"
+
+void SimulationParameterOverrides::applyTo(SimulationParameters& parameters) const
+{
+    if (mode) parameters.mode = *mode;
+    if (bulkMode) parameters.bulkMode = *bulkMode;
+    if (graphicsOn) parameters.graphicsOn = *graphicsOn;
+    if (timeToRun) parameters.timeToRun = *timeToRun;
+    if (dt) parameters.dt = *dt;
+    if (diffusionCoefficient) parameters.diffusionCoefficient = *diffusionCoefficient;
+    if (iterationsPerFrame) parameters.iterationsPerFrame = *iterationsPerFrame;
+    if (firstPassageJumps) parameters.firstPassageJumps = *firstPassageJumps;
+    if (firstPassageSafety) parameters.firstPassageSafety = *firstPassageSafety;
+    if (firstPassageMaxSteps) parameters.firstPassageMaxSteps = *firstPassageMaxSteps;
+}
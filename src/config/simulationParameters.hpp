@@ -0,0 +1,54 @@
+//
+//  simulationParameters.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef simulationParameters_hpp
+#define simulationParameters_hpp
+
+#include <stdio.h>
+#include <optional>
+#include <src/config/config.h>
+
+// Run parameters that used to be fixed at compile time.
+// The macros in config.h are now only the defaults: a network YAML can change them in its
+// simulation: section and command line flags override both, so sweeps need no rebuild.
+struct SimulationParameters {
+    int mode = MODE; // 0 for single simulation, 1 for simulation network
+    bool bulkMode = BULKMODE;
+    bool graphicsOn = GRAPHICS_ON;
+    double timeToRun = TIME_TO_RUN;
+    double dt = DT;
+    double diffusionCoefficient = D;
+    int iterationsPerFrame = ITERATIONS_PER_FRAME;
+    bool firstPassageJumps = FIRST_PASSAGE_JUMPS;
+    double firstPassageSafety = FIRST_PASSAGE_SAFETY;
+    int firstPassageMaxSteps = FIRST_PASSAGE_MAX_STEPS;
+    
+    // Was NUMBER_OF_ITERATIONS
+    int getIterationCount() const;
+};
+
+inline int SimulationParameters::getIterationCount() const {
+    return static_cast<int>(timeToRun / dt);
+}
+
+// Parameters given explicitly (on the command line), applied on top of whatever else set them
+struct SimulationParameterOverrides {
+    std::optional<int> mode;
+    std::optional<bool> bulkMode;
+    std::optional<bool> graphicsOn;
+    std::optional<double> timeToRun;
+    std::optional<double> dt;
+    std::optional<double> diffusionCoefficient;
+    std::optional<int> iterationsPerFrame;
+    std::optional<bool> firstPassageJumps;
+    std::optional<double> firstPassageSafety;
+    std::optional<int> firstPassageMaxSteps;
+    
+    void applyTo(SimulationParameters& parameters) const;
+};
+
+#endif /* simulationParameters_hpp */
@@ -0,0 +1,35 @@
+//
+//  boundaryVariant.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef boundaryVariant_hpp
+#define boundaryVariant_hpp
+
+#include <variant>
+#include "noBoundary.hpp"
+#include "box.hpp"
+#include "cylinder.hpp"
+
+// The concrete type of a simulation's boundary, known from construction on.
+// Stepping code visits it once per step and runs a loop compiled for that one boundary type,
+// so the per-particle code makes direct (inlinable) calls instead of virtual calls and dynamic_casts.
+using BoundaryVariant = std::variant<NoBoundary*, Box*, Cylinder*>;
+
+// Moves newPosition back inside the boundary, reflecting as many times as needed
+template <class BoundaryT>
+inline glm::dvec3 reflectInside(const BoundaryT& boundary, const glm::dvec3& oldPosition, glm::dvec3 newPosition) {
+    while (boundary.isOutsideBoundaries(newPosition)) {
+        newPosition = boundary.reflectParticle(oldPosition, newPosition);
+    }
+    return newPosition;
+}
+
+template <>
+inline glm::dvec3 reflectInside<NoBoundary>(const NoBoundary&, const glm::dvec3&, glm::dvec3 newPosition) {
+    return newPosition;
+}
+
+#endif /* boundaryVariant_hpp */
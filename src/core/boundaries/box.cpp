@@ -8,11 +8,10 @@
 #include "box.hpp"
 
 Box::Box() {
-    if (MODE == 0) {
-        boundaryX = SINGLE_BOX_BOUNDARY_X;
-        boundaryY = SINGLE_BOX_BOUNDARY_Y;
-        boundaryZ = SINGLE_BOX_BOUNDARY_Z;
-    }
+    // Boxes only exist in single simulations
+    boundaryX = SINGLE_BOX_BOUNDARY_X;
+    boundaryY = SINGLE_BOX_BOUNDARY_Y;
+    boundaryZ = SINGLE_BOX_BOUNDARY_Z;
 }
 
 double Box::getBoundaryZ(double x, double y) const {
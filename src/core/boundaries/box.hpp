@@ -14,7 +14,7 @@
 #include <glm/glm.hpp>
 #include "boundary.hpp"
 
-class Box: public Boundary { // inheriting from boundary
+class Box final: public Boundary { // inheriting from boundary
 private:
     double boundaryX;
     double boundaryY;
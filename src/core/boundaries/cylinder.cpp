@@ -6,17 +6,12 @@
 //
 
 #include "cylinder.hpp"
+#include <stdexcept>
 
-Cylinder::Cylinder(double radius, double length) {
-    if (MODE == 0) {
-        orientation = SINGLE_CYLINDER_ORIENTATION;
-        this->radius = radius;
-        zLimit = length;
-    } else if (MODE == 1) {
-        orientation = 2;
-        this->radius = radius;
-        zLimit = length;
-    }
+Cylinder::Cylinder(double radius, double length, int orientation) {
+    this->orientation = orientation;
+    this->radius = radius;
+    zLimit = length;
 }
 
 glm::dvec3 Cylinder::orientPosition(const glm::dvec3& position) const {
@@ -59,13 +54,11 @@ glm::dvec3 Cylinder::reflectParticle(const glm::dvec3& oldPos, const glm::dvec3&
 
     double radialDistSq = orientedNew.x * orientedNew.x + orientedNew.y * orientedNew.y;
 
-    // Reflect off the cylindrical wall (x, y direction)
+    // Reflect off the cylindrical wall (x, y direction), all the bounces of the move at once
     if (radialDistSq > radius * radius) {
-        glm::dvec2 old2d(orientedOld.x, orientedOld.y);
-        glm::dvec2 new2d(orientedNew.x, orientedNew.y);
-
         // For now cylinder center is 0,0
-        glm::dvec2 reflected2d = reflectingOffCircle(old2d, new2d, glm::dvec2(0.0, 0.0), radius);
+        glm::dvec2 reflected2d = reflectInsideCircle(glm::dvec2(orientedOld.x, orientedOld.y),
+                                                     glm::dvec2(orientedNew.x, orientedNew.y), radius);
         
         reflectedPos.x = reflected2d.x;
         reflectedPos.y = reflected2d.y;
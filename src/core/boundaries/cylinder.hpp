@@ -11,10 +11,10 @@
 #include <glm/glm.hpp>
 #include <src/config/config.h>
 #include <src/config/unused/oldconfig.h>
-#include <src/math/geometry2d.hpp>
+#include <src/math/circleReflection.hpp>
 #include "boundary.hpp"
 
-class Cylinder: public Boundary {
+class Cylinder final: public Boundary {
 private:
     int orientation;
     double radius;
@@ -24,7 +24,8 @@ private:
     glm::dvec3 deorientPosition(const glm::dvec3& position) const;
 
 public:
-    Cylinder(double radius = SINGLE_CYLINDER_R, double length = SINGLE_CYLINDER_Z);
+    // orientation: central axis along 0=X 1=Y 2=Z, network pipes always use 2
+    Cylinder(double radius = SINGLE_CYLINDER_R, double length = SINGLE_CYLINDER_Z, int orientation = SINGLE_CYLINDER_ORIENTATION);
     
     bool isOutsideBoundaries(const glm::dvec3& position) const override;
     glm::dvec3 reflectParticle(const glm::dvec3& oldPosition, const glm::dvec3& newPosition) const override;
@@ -11,7 +11,7 @@
 #include <stdio.h>
 #include "boundary.hpp"
 
-class NoBoundary: public Boundary
+class NoBoundary final: public Boundary
 {
 public:
     NoBoundary();
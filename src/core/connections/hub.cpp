@@ -5,32 +5,103 @@
 //  Created by Dağhan Erdönmez on 3.02.2025.
 //
 
+#define _USE_MATH_DEFINES
 #include "hub.hpp"
 #include "simulation.hpp"
+#include <algorithm>
+#include <cmath>
 
 Hub::Hub()
-{
-    std::random_device rd;
-    gen = std::mt19937(rd());
+{}
+
+void Hub::setRandomStream(const RandomStream& stream) {
+    random = stream;
 }
 
 void Hub::addDirectedConnection(DirectedConnection directedConnection) {
     directedConnections.push_back(directedConnection);
 }
 
-void Hub::initializeProbabilities() {
-    totalSquaredRadius = 0;
-    cumulativeProbabilities.clear();
+void Hub::setRouting(HubRouting routing) {
+    this->routing = routing;
+}
 
-    for (DirectedConnection directedConnection : directedConnections) {
-        // Assuming only Simulation connections have boundaries
-        Simulation* sim = dynamic_cast<Simulation*>(directedConnection.connection);
-        if (sim) {
-            double radius = sim->getBoundaryRadius();
-            totalSquaredRadius += radius * radius;
-            cumulativeProbabilities.push_back(totalSquaredRadius);
+double Hub::branchWeight(const DirectedConnection& connection) const {
+    double radius = connection.simulation->getBoundaryRadius();
+    
+    switch (routing) {
+        case HubRouting::RADIUS_SQUARED:
+            return radius * radius;
+        case HubRouting::POISEUILLE:
+            return radius * radius * radius * radius / connection.simulation->getBoundaryHeight();
+        case HubRouting::WEIGHTS:
+            return connection.weight;
+        case HubRouting::FLUX: {
+            // Flow runs along +z, so a positive flow leaves the hub into a pipe's left end and a negative one into its right end.
+            // The flux is the mean Poiseuille velocity (half the centreline one) times the cross-section.
+            double flow = connection.simulation->getFlow(glm::dvec3(0.0)).z;
+            double outward = (connection.direction == Direction::LEFT) ? flow : -flow;
+            return outward > 0 ? outward * 0.5 * M_PI * radius * radius : 0.0;
         }
     }
+    return 0.0;
+}
+
+void Hub::initializeProbabilities() {
+    int branchCount = static_cast<int>(directedConnections.size());
+    totalWeight = 0;
+    aliasProbability.assign(branchCount, 1.0);
+    aliasIndex.resize(branchCount);
+    
+    std::vector<double> weights(branchCount);
+    for (int i = 0; i < branchCount; ++i) {
+        weights[i] = std::max(branchWeight(directedConnections[i]), 0.0);
+        totalWeight += weights[i];
+        aliasIndex[i] = i;
+    }
+    if (totalWeight <= 0 && routing == HubRouting::FLUX) {
+        // Nothing flows out of this hub (a dead end or still fluid): particles only diffuse, split by cross-section
+        for (int i = 0; i < branchCount; ++i) {
+            double radius = directedConnections[i].simulation->getBoundaryRadius();
+            weights[i] = radius * radius;
+            totalWeight += weights[i];
+        }
+    }
+    probability.assign(branchCount, 0.0);
+    if (totalWeight <= 0) {
+        return;
+    }
+    for (int i = 0; i < branchCount; ++i) {
+        probability[i] = weights[i] / totalWeight;
+    }
+    
+    // Vose's method: scale the weights to average 1, then repeatedly top up an underfull
+    // branch with the excess of an overfull one
+    std::vector<double> scaled(branchCount);
+    std::vector<int> small, large;
+    for (int i = 0; i < branchCount; ++i) {
+        scaled[i] = weights[i] * branchCount / totalWeight;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        int under = small.back();
+        small.pop_back();
+        int over = large.back();
+        aliasProbability[under] = scaled[under];
+        aliasIndex[under] = over;
+        scaled[over] -= 1.0 - scaled[under];
+        if (scaled[over] < 1.0) {
+            large.pop_back();
+            small.push_back(over);
+        }
+    }
+    // Whatever is left is full up to rounding
+    for (int i : large) {
+        aliasProbability[i] = 1.0;
+    }
+    for (int i : small) {
+        aliasProbability[i] = 1.0;
+    }
 }
 
 // Overload the output operator for Direction
@@ -52,17 +123,17 @@ std::ostream& operator<<(std::ostream& os, Direction direction) {
 
 void Hub::simulateParticleTransaction(Particle* particle, double overflow)
 {
-    std::uniform_real_distribution<> dis(0, totalSquaredRadius);
-    double randomValue = dis(gen);
+    if (totalWeight <= 0) {
+        return; // no branch to go to
+    }
     
-    for (size_t i = 0; i < cumulativeProbabilities.size(); ++i) {
-            if (randomValue < cumulativeProbabilities[i]) {
-                DirectedConnection dc = directedConnections[i];
-                Simulation* sim = dynamic_cast<Simulation*>(dc.connection);
-                sim->receiveParticle(particle, dc.direction, overflow);
-                return;
-            }
-        }
+    // One uniform picks both the column and the coin flip within it
+    double scaled = random.nextUniform() * aliasProbability.size();
+    int column = static_cast<int>(scaled);
+    int branch = (scaled - column < aliasProbability[column]) ? column : aliasIndex[column];
+    
+    const DirectedConnection& dc = directedConnections[branch];
+    dc.simulation->receiveParticle(particle, dc.direction, overflow);
 }
 
 // I am not actually using the particle pointer in any of the operations in this functions but I don't know whether it is a good idea to delete them. It causes no problem for now so I'll just leave it.
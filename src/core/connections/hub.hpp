@@ -10,30 +10,58 @@
 
 #include <stdio.h>
 #include <vector>
-#include <random>
 #include "connection.hpp"
+#include <src/math/randomStream.hpp>
 
+class Simulation;
+
+// A hub only ever hands particles to pipes, so its targets are kept with their concrete type
 struct DirectedConnection {
-    Connection* connection;
+    Simulation* simulation;
     Direction direction;
+    double weight = 1.0; // routing weight given in the YAML, only used by HubRouting::WEIGHTS
+};
+
+// How a hub splits the particles it receives between its branches
+enum class HubRouting {
+    RADIUS_SQUARED, // by cross-section, r^2 (the original model)
+    POISEUILLE,     // by Poiseuille conductance, r^4 / L
+    WEIGHTS,        // by the weights given per pipe side in the YAML
+    FLUX            // by the volume flux leaving the hub through each branch, branches flowing into the hub get nothing
 };
 
 class Hub: public Connection
 {
 private:
     std::vector<DirectedConnection> directedConnections;
-    double totalSquaredRadius = 0;
-    std::vector<double> cumulativeProbabilities;
-    std::mt19937 gen;
+    HubRouting routing = HubRouting::RADIUS_SQUARED;
+    double totalWeight = 0;
+    // Walker alias table over the branch weights of the routing model: branch i is kept with
+    // probability aliasProbability[i] and swapped for aliasIndex[i] otherwise, so a pick costs one
+    // uniform draw and no search however many branches the hub has
+    std::vector<double> aliasProbability;
+    std::vector<int> aliasIndex;
+    std::vector<double> probability; // of each branch, what the alias table draws from
+    RandomStream random; // picks the outgoing branch
+    
+    // Unnormalized probability of a branch under the routing model
+    double branchWeight(const DirectedConnection& connection) const;
     
 public:
     Hub();
     void addDirectedConnection(DirectedConnection directedConnection);
+    void setRouting(HubRouting routing);
     void simulateParticleTransaction(Particle* particle, double overflow);
+    // Builds the alias table from the routing model, once all the connections are added
     void initializeProbabilities();
+    // Chance that a received particle goes to branch (in the order the connections were added), 0 when it is lost
+    double branchProbability(int branch) const;
+    void setRandomStream(const RandomStream& stream);
     
     void receiveParticle(Particle* particle, Direction direction, double overflow) override;
 };
 
+inline double Hub::branchProbability(int branch) const { return probability[branch]; }
+
 #endif /* hub_hpp */
 
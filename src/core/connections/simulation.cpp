@@ -7,21 +7,66 @@
 
 #include "simulation.hpp"
 #include "hub.hpp"
+#include <src/core/kernels/brownianKernel.hpp>
+#include <src/core/kernels/firstPassage.hpp>
+#include <algorithm>
+#include <limits>
 #include <cstdlib> // For system()
 
+namespace {
+
+// Poiseuille profile: flow is the centreline velocity, zero at the wall
+inline glm::dvec3 flowAt(const Cylinder& cylinder, const glm::dvec3& flow, const glm::dvec3& position) {
+    double x = position.x;
+    double y = position.y;
+    double z = position.z;
+    double R = cylinder.getRadius();
+    double rsquared;
+    int cylinderOrientation = cylinder.getOrientation();
+    if (cylinderOrientation == 0) {
+        rsquared = (y*y + z*z);
+    } else if(cylinderOrientation == 1){
+        rsquared = (x*x + z*z);
+    } else {
+        rsquared = (x*x + y*y);
+    }
+    return flow * (1-(rsquared)/(R*R));
+}
+
+// Without a wall there is no profile, the flow is the same everywhere
+template <class BoundaryT>
+inline glm::dvec3 flowAt(const BoundaryT&, const glm::dvec3& flow, const glm::dvec3&) {
+    return flow;
+}
+
+} // end anonymous namespace
+
 Simulation::~Simulation() {}
 
-Simulation::Simulation(int particleCount, double radius, double length, glm::dvec3 flow) {
-    if (MODE == 0) { // Single simulation
+template <class BoundaryT>
+void Simulation::setBoundary(std::unique_ptr<BoundaryT> newBoundary)
+{
+    typedBoundary = newBoundary.get();
+    if constexpr (std::is_same<BoundaryT, Cylinder>::value) {
+        cylinder = newBoundary.get();
+    } else {
+        cylinder = nullptr;
+    }
+    boundary = std::move(newBoundary);
+}
+
+Simulation::Simulation(int particleCount, double radius, double length, glm::dvec3 flow, const SimulationParameters& parameters)
+    : parameters(parameters), motionRandom(0, 0), inletRandom(0, 1) {
+    if (parameters.mode == 0) { // Single simulation
         this->flow = flow;
         aliveParticleCount = particleCount;
         
         if (SINGLE_APPLIED_BOUNDARY == 0) {
-            boundary = std::make_unique<NoBoundary>();
+            setBoundary(std::make_unique<NoBoundary>());
         } else if (SINGLE_APPLIED_BOUNDARY == 1) {
-            boundary = std::make_unique<Box>();
+            setBoundary(std::make_unique<Box>());
         } else if (SINGLE_APPLIED_BOUNDARY == 2) {
-            boundary = std::make_unique<Cylinder>();
+            setBoundary(std::make_unique<Cylinder>());
         }
 
         
@@ -41,10 +86,10 @@ Simulation::Simulation(int particleCount, double radius, double length, glm::dve
         if (SINGLE_RECEIVER_COUNT != 0) {
             addReceiver(std::make_unique<SphericalReceiver>(glm::dvec3(SINGLE_RECEIVER_X, SINGLE_RECEIVER_Y, SINGLE_RECEIVER_Z),0 ,SINGLE_RECEIVER_RADIUS));
         }
-    } else if (MODE == 1) {
+    } else if (parameters.mode == 1) {
         this->flow = flow;
         aliveParticleCount = particleCount;
-        boundary = std::make_unique<Cylinder>(radius, length);
+        setBoundary(std::make_unique<Cylinder>(radius, length, 2)); // network pipes run along z
         
         particles.reserve(particleCount);
         
@@ -60,110 +105,380 @@ Simulation::Simulation(int particleCount, double radius, double length, glm::dve
 void Simulation::iterateSimulation(int iterationCount, int currentFrame, int iterationInCurrentFrame)
 {
     //std::cout << aliveParticleCount << std::endl;
-    if (MODE == 0) {
-        if (SINGLE_RECEIVER_COUNT != 0) {
-            // for each iteration
-            for(int i = 0; i < iterationCount; ++i) {
-                
-                for (auto& emitter : emitters) {
-                    emitter->emit(currentFrame);
-                }
-                
-                // for each particle
-                for(int j = 0; j < particles.size(); ++j) {
-                    if (particles[j].isAlive()) {
-                        // calculate their displacements
-                        // in brownian motion displacements in each iteration are standard normal distributions
-                        glm::dvec3 particlePosition = particles[j].getPosition();
-                        glm::dvec3 flowVector = getFlow(particlePosition);
-                        
-                        double dx = generateGaussian(0.0, sqrt(2 * D * DT)) + flowVector.x * DT;
-                        double dy = generateGaussian(0.0, sqrt(2 * D * DT)) + flowVector.y * DT;
-                        double dz = generateGaussian(0.0, sqrt(2 * D * DT)) + flowVector.z * DT;
-                        bool toBeKilled = false;
-                        particles[j].move(dx, dy, dz, &toBeKilled);
-                        
-                        for (int k = 0; k < SINGLE_RECEIVER_COUNT; ++k) {
-                            //check if they are received by the receivers
-                            Receiver* receiver = receivers[k].get();
-                            if (checkReceivedForParticle(particles[j], *receiver)) {
-                                killParticle(j);
-                                receiver->increaseParticlesReceived(currentFrame * ITERATIONS_PER_FRAME + i + iterationInCurrentFrame);
-                                // I added iterationInCurrentFrame for the network simulation case but also added it here since its default value is 0
-                            }
-                        }
-                    }
+    if (parameters.mode == 0) {
+        // The boundary type is resolved here once, the loop itself has no virtual calls
+        std::visit([&](auto* typed) {
+            iterateSingle(*typed, iterationCount, currentFrame, iterationInCurrentFrame);
+        }, typedBoundary);
+    } else if (parameters.mode == 1) {
+        StepResult result;
+        
+        // for each iteration
+        for(int i = 0; i < iterationCount; ++i) {
+            int blockCount = beginStep(currentFrame, iterationInCurrentFrame + i);
+            stepBlocks(0, blockCount, result);
+            finishStep(&result, 1);
+        }
+    }
+}
+
+template <class BoundaryT>
+void Simulation::iterateSingle(const BoundaryT& typedBoundary, int iterationCount, int currentFrame, int iterationInCurrentFrame)
+{
+    double sigma = sqrt(2 * parameters.diffusionCoefficient * parameters.dt);
+    
+    // for each iteration
+    for(int i = 0; i < iterationCount; ++i) {
+        
+        fireEmitters();
+        
+        // for each particle
+        for(int j = 0; j < particles.size(); ++j) {
+            // calculate their displacements
+            // in brownian motion displacements in each iteration are standard normal distributions
+            glm::dvec3 particlePosition = particles.getPosition(j);
+            glm::dvec3 flowVector = flowAt(typedBoundary, flow, particlePosition);
+            
+            double dx = generateGaussian(motionRandom, 0.0, sigma) + flowVector.x * parameters.dt;
+            double dy = generateGaussian(motionRandom, 0.0, sigma) + flowVector.y * parameters.dt;
+            double dz = generateGaussian(motionRandom, 0.0, sigma) + flowVector.z * parameters.dt;
+            particles.setPosition(j, reflectInside(typedBoundary, particlePosition, particlePosition + glm::dvec3(dx, dy, dz)));
+            
+            bool received = false;
+            for (int k = 0; k < SINGLE_RECEIVER_COUNT; ++k) {
+                //check if they are received by the receivers
+                Receiver* receiver = receivers[k].get();
+                if (checkReceivedForParticle(particles.getPosition(j), *receiver)) {
+                    received = true;
+                    receiver->increaseParticlesReceived(currentFrame * parameters.iterationsPerFrame + i + iterationInCurrentFrame);
+                    // I added iterationInCurrentFrame for the network simulation case but also added it here since its default value is 0
                 }
             }
-        } else {
-            // for each iteration
-            for(int i = 0; i < iterationCount; ++i) {
-                
-                for (auto& emitter : emitters) {
-                    emitter->emit(currentFrame);
-                }
-                
-                // for each particle
-                for(int j = 0; j < particles.size(); ++j) {
-                    if (particles[j].isAlive()) {
-                        // calculate their displacements
-                        // in brownian motion displacements in each iteration are standard normal distributions
-                        glm::dvec3 particlePosition = particles[j].getPosition();
-                        glm::dvec3 flowVector = getFlow(particlePosition);
-                        
-                        double dx = generateGaussian(0.0, sqrt(2 * D * DT)) + flowVector.x * DT;
-                        double dy = generateGaussian(0.0, sqrt(2 * D * DT)) + flowVector.y * DT;
-                        double dz = generateGaussian(0.0, sqrt(2 * D * DT)) + flowVector.z * DT;
-                        bool toBeKilled = false;
-                        particles[j].move(dx, dy, dz, &toBeKilled);
-                    }
-                }
+            if (received) {
+                // The last particle, not stepped yet this iteration, moves into slot j
+                killParticle(j);
+                --j;
             }
         }
-    } else if (MODE == 1) {
-        // for each iteration
-        for(int i = 0; i < iterationCount; ++i) {
-            
-            for (auto& emitter : emitters) {
-                emitter->emit(currentFrame);
+    }
+}
+
+void Simulation::fireEmitters()
+{
+    if (!emittersScheduled && nextEmission <= emissionStep) {
+        nextEmission = EmissionSchedule::NEVER;
+        for (auto& emitter : emitters) {
+            emitter->emitDue(emissionStep);
+            nextEmission = std::min(nextEmission, emitter->getNextEmission());
+        }
+    }
+    ++emissionStep;
+}
+
+void StepResult::reset(int receiverCount)
+{
+    killed.clear();
+    handoffs.clear();
+    receiverHits.assign(receiverCount, 0);
+}
+
+int Simulation::beginStep(int currentFrame, int iterationInCurrentFrame)
+{
+    if (!cylinder) {
+        throw std::runtime_error("Boundary is not of type Cylinder.");
+    }
+    
+    stepParams.radius = cylinder->getRadius();
+    stepParams.zLimit = cylinder->getHeight();
+    stepParams.flowX = flow.x;
+    stepParams.flowY = flow.y;
+    stepParams.flowZ = flow.z;
+    stepParams.dt = parameters.dt;
+    stepParams.sigma = sqrt(2 * parameters.diffusionCoefficient * parameters.dt);
+    firstPassageLimits.safety = parameters.firstPassageSafety;
+    firstPassageLimits.maxSteps = parameters.firstPassageMaxSteps;
+    
+    flushInbox();
+    fireEmitters();
+    
+    stepIterationNumber = currentFrame * parameters.iterationsPerFrame + iterationInCurrentFrame;
+    
+    // Particles added from here on (hand-offs) wait for the next step
+    stepSlotCount = particles.size();
+    return (stepSlotCount + BROWNIAN_BLOCK_SIZE - 1) / BROWNIAN_BLOCK_SIZE;
+}
+
+void Simulation::stepBlocks(int firstBlock, int endBlock, StepResult& result)
+{
+    result.reset(static_cast<int>(receivers.size()));
+    
+    // Scratch for one block of the kernel
+    int slots[BROWNIAN_BLOCK_SIZE];
+    double oldX[BROWNIAN_BLOCK_SIZE];
+    double oldY[BROWNIAN_BLOCK_SIZE];
+    double oldZ[BROWNIAN_BLOCK_SIZE];
+    double noise[3 * BROWNIAN_BLOCK_SIZE];
+    double newX[BROWNIAN_BLOCK_SIZE];
+    double newY[BROWNIAN_BLOCK_SIZE];
+    double newZ[BROWNIAN_BLOCK_SIZE];
+    uint8_t outcome[BROWNIAN_BLOCK_SIZE];
+    uint8_t leftPipe[BROWNIAN_BLOCK_SIZE];
+    uint8_t absorbed[BROWNIAN_BLOCK_SIZE];
+    int jumpSteps[BROWNIAN_BLOCK_SIZE];
+    int receiverCount = static_cast<int>(receivers.size());
+    const int* wakes = particles.wakeIterations();
+    
+    // for each block of particles
+    for (int block = firstBlock; block < endBlock; ++block) {
+        int blockStart = block * BROWNIAN_BLOCK_SIZE;
+        int blockEnd = std::min(blockStart + BROWNIAN_BLOCK_SIZE, stepSlotCount);
+        
+        // Gather the slots of the block into contiguous scratch for the kernel.
+        // Particles still in a first-passage jump are left where it put them.
+        int blockCount = 0;
+        for (int j = blockStart; j < blockEnd; ++j) {
+            if (wakes[j] <= stepIterationNumber) {
+                slots[blockCount] = j;
+                oldX[blockCount] = particles.x()[j];
+                oldY[blockCount] = particles.y()[j];
+                oldZ[blockCount] = particles.z()[j];
+                blockCount++;
             }
+        }
+        if (blockCount == 0) {
+            continue;
+        }
+        
+        // in brownian motion displacements in each iteration are standard normal distributions
+        // The stream position only depends on the iteration and the block, not on what ran before
+        // or on which thread, so every block can seek on its own copy of the stream
+        RandomStream blockRandom = motionRandom;
+        blockRandom.seek((static_cast<uint64_t>(stepIterationNumber) << 24) | static_cast<uint64_t>(block));
+        blockRandom.fillNormal(noise, 3 * blockCount);
+        advanceCylinderBlock(stepParams, oldX, oldY, oldZ, noise, newX, newY, newZ, outcome, blockCount);
+        if (parameters.firstPassageJumps) {
+            takeFirstPassageJumps(blockRandom, oldX, oldY, oldZ, newX, newY, newZ, outcome, jumpSteps, blockCount);
+        }
+        reflectWallCrossings(stepParams, oldX, oldY, newX, newY, outcome, blockCount);
+
+        for (int b = 0; b < blockCount; ++b) {
+            int j = slots[b];
+            leftPipe[b] = 0;
+            absorbed[b] = 0;
             
-            // for each particle
-            for(int j = 0; j < particles.size(); ++j) {
-                if (particles[j].isAlive()) {
-                    // calculate their displacements
-                    // in brownian motion displacements in each iteration are standard normal distributions
-                    glm::dvec3 particlePosition = particles[j].getPosition();
-                    glm::dvec3 flowVector = getFlow(particlePosition);
-                    
-                    double dx = generateGaussian(0.0, sqrt(2 * D * DT)) + flowVector.x * DT;
-                    double dy = generateGaussian(0.0, sqrt(2 * D * DT)) + flowVector.y * DT;
-                    double dz = generateGaussian(0.0, sqrt(2 * D * DT)) + flowVector.z * DT;
-                    bool toBeKilled = false;
-                    particles[j].move(dx, dy, dz, &toBeKilled);
-                    
-                    if (toBeKilled) {
-                        killParticle(j);
-                    } else {
-                        for (int k = 0; k < receivers.size(); ++k) {
-                            //check if they are received by the receivers
-                            Receiver* receiver = receivers[k].get();
-                            if (checkReceivedForParticle(particles[j], *receiver)) {
-                                if (receiver->getCountingType() == 0){
-                                    killParticle(j);
-                                }
-                                receiver->increaseParticlesReceived(currentFrame * ITERATIONS_PER_FRAME + i + iterationInCurrentFrame);
-                            }
-                        }
-                    }
+            if (outcome[b] == STEP_INSIDE) {
+                particles.setPosition(j, glm::dvec3(newX[b], newY[b], newZ[b]));
+            } else {
+                // Only the particles that crossed an end take the scalar path
+                Handoff handoff;
+                if (resolveCylinderStep(j, glm::dvec3(newX[b], newY[b], newZ[b]), &handoff)) {
+                    result.handoffs.push_back(handoff);
+                    leftPipe[b] = 1;
+                    continue;
                 }
+                newX[b] = particles.x()[j];
+                newY[b] = particles.y()[j];
+                newZ[b] = particles.z()[j];
+            }
+        }
+        
+        if (receiverCount > 0) {
+            testReceivers(newX, newY, newZ, leftPipe, absorbed, blockCount, result);
+        }
+        
+        // Slots are freed in slot order, whatever took the particle
+        for (int b = 0; b < blockCount; ++b) {
+            if (leftPipe[b] || absorbed[b]) {
+                result.killed.push_back(slots[b]);
+            } else if (parameters.firstPassageJumps && jumpSteps[b] > 0) {
+                particles.setWakeIteration(slots[b], stepIterationNumber + jumpSteps[b]);
+            }
+        }
+    }
+}
+
+void Simulation::takeFirstPassageJumps(RandomStream& random, const double* x, const double* y, const double* z,
+                                       double* newX, double* newY, double* newZ, uint8_t* outcome, int* jumpSteps, int count) const
+{
+    int jumpCount = 0;
+    for (int b = 0; b < count; ++b) {
+        // The wall and the pipe ends bound every jump, then the receivers: first by how far their z range is,
+        // which is cheap, and where that is what holds the particle back by how far the nearest one really is
+        int wallSteps = firstPassageSteps(stepParams, firstPassageLimits, x[b], y[b], z[b], std::numeric_limits<double>::infinity());
+        int steps = 0;
+        if (wallSteps > 0) {
+            steps = firstPassageSteps(stepParams, firstPassageLimits, x[b], y[b], z[b], receiverIndex.axialClearance(z[b]));
+            if (steps < wallSteps) {
+                double reach = firstPassageReach(stepParams, firstPassageLimits, x[b], y[b], wallSteps);
+                double clearance = receiverIndex.clearance(x[b], y[b], z[b], reach);
+                steps = std::max(steps, std::min(wallSteps, firstPassageStepsWithin(stepParams, firstPassageLimits, x[b], y[b], clearance)));
+            }
+        }
+        jumpSteps[b] = steps;
+        jumpCount += (steps > 0);
+    }
+    if (jumpCount == 0) {
+        return;
+    }
+    
+    double normals[FIRST_PASSAGE_NORMALS * BROWNIAN_BLOCK_SIZE];
+    random.fillNormal(normals, FIRST_PASSAGE_NORMALS * jumpCount);
+    const double* next = normals;
+    for (int b = 0; b < count; ++b) {
+        if (jumpSteps[b] > 0) {
+            outcome[b] = firstPassageJump(stepParams, x[b], y[b], z[b], jumpSteps[b], next, newX[b], newY[b], newZ[b]);
+            next += FIRST_PASSAGE_NORMALS;
+        }
+    }
+}
+
+void Simulation::testReceivers(const double* x, const double* y, const double* z,
+                               const uint8_t* skip, uint8_t* absorbed, int count, StepResult& result) const
+{
+    int receiverCount = static_cast<int>(receivers.size());
+    std::vector<int>& bucketStart = result.bucketStart;
+    std::vector<int>& bucketFill = result.bucketFill;
+    std::vector<int>& bucketLanes = result.bucketLanes;
+    
+    // Bucket the particles by receiver: every particle goes to the receivers of its slab (counting sort)
+    bucketStart.assign(receiverCount + 1, 0);
+    for (int b = 0; b < count; ++b) {
+        if (skip[b]) {
+            continue;
+        }
+        const int* candidates = nullptr;
+        int candidateCount = receiverIndex.candidates(z[b], &candidates);
+        for (int c = 0; c < candidateCount; ++c) {
+            bucketStart[candidates[c] + 1]++;
+        }
+    }
+    for (int k = 0; k < receiverCount; ++k) {
+        bucketStart[k + 1] += bucketStart[k];
+    }
+    bucketLanes.resize(bucketStart[receiverCount]);
+    bucketFill.assign(bucketStart.begin(), bucketStart.end() - 1);
+    for (int b = 0; b < count; ++b) {
+        if (skip[b]) {
+            continue;
+        }
+        const int* candidates = nullptr;
+        int candidateCount = receiverIndex.candidates(z[b], &candidates);
+        for (int c = 0; c < candidateCount; ++c) {
+            bucketLanes[bucketFill[candidates[c]]++] = b;
+        }
+    }
+    
+    // Then one batch test per receiver over its own particles
+    double bucketX[BROWNIAN_BLOCK_SIZE];
+    double bucketY[BROWNIAN_BLOCK_SIZE];
+    double bucketZ[BROWNIAN_BLOCK_SIZE];
+    uint8_t mask[BROWNIAN_BLOCK_SIZE];
+    for (int k = 0; k < receiverCount; ++k) {
+        const int* lanes = bucketLanes.data() + bucketStart[k];
+        int laneCount = bucketStart[k + 1] - bucketStart[k];
+        if (laneCount == 0) {
+            continue;
+        }
+        for (int i = 0; i < laneCount; ++i) {
+            bucketX[i] = x[lanes[i]];
+            bucketY[i] = y[lanes[i]];
+            bucketZ[i] = z[lanes[i]];
+        }
+        
+        //check if they are received by the receivers
+        receivers[k]->hitBatch(bucketX, bucketY, bucketZ, laneCount, mask);
+        
+        bool absorbing = receivers[k]->getCountingType() == 0;
+        int hits = 0;
+        for (int i = 0; i < laneCount; ++i) {
+            hits += mask[i];
+            if (absorbing) {
+                absorbed[lanes[i]] |= mask[i];
+            }
+        }
+        result.receiverHits[k] += hits;
+    }
+}
+
+void Simulation::finishStep(const StepResult* results, int resultCount)
+{
+    // Kills go last slot first: every particle moved into a freed slot then comes from a slot already passed
+    for (int r = resultCount - 1; r >= 0; --r) {
+        const std::vector<int>& killed = results[r].killed;
+        for (auto index = killed.rbegin(); index != killed.rend(); ++index) {
+            killParticle(*index);
+        }
+    }
+    for (int r = 0; r < resultCount; ++r) {
+        const StepResult& result = results[r];
+        for (int k = 0; k < result.receiverHits.size(); ++k) {
+            if (result.receiverHits[k] != 0) {
+                receivers[k]->increaseParticlesReceived(stepIterationNumber, result.receiverHits[k]);
             }
         }
+        for (const Handoff& handoff : result.handoffs) {
+            handOff(handoff);
+        }
     }
 }
 
-bool Simulation::checkReceivedForParticle(const Particle& particle, const Receiver& receiver) const {
-    return receiver.hit(particle.getPosition());
+bool Simulation::checkReceivedForParticle(const glm::dvec3& particlePosition, const Receiver& receiver) const {
+    return receiver.hit(particlePosition);
+}
+
+void Simulation::moveParticle(int index, double dx, double dy, double dz, bool* toBeKilled)
+{
+    moveParticleTo(index, particles.getPosition(index) + glm::dvec3(dx,dy,dz), toBeKilled);
+}
+
+void Simulation::moveParticleTo(int index, glm::dvec3 newPosition, bool* toBeKilled)
+{
+    glm::dvec3 position = particles.getPosition(index);
+    
+    if (parameters.mode == 0) {
+        std::visit([&](auto* typed) {
+            newPosition = reflectInside(*typed, position, newPosition);
+        }, typedBoundary);
+        particles.setPosition(index, newPosition);
+    } else if (parameters.mode == 1) {
+        if (!boundary) {
+            throw std::runtime_error("boundary is null.");
+        }
+        Handoff handoff;
+        if (resolveCylinderStep(index, newPosition, &handoff)) {
+            handOff(handoff);
+            *toBeKilled = true;
+        }
+    }
+}
+
+bool Simulation::resolveCylinderStep(int index, glm::dvec3 newPosition, Handoff* handoff)
+{
+    glm::dvec3 position = particles.getPosition(index);
+    
+    if (!cylinder) {
+        throw std::runtime_error("Boundary is not of type Cylinder while moving.");
+    }
+    
+    if (cylinder->isOutsideRightZBoundary(newPosition)) {
+        if (rightConnection == nullptr) {
+            newPosition = cylinder->reflectParticle(position, newPosition);
+        } else {
+            *handoff = { Direction::RIGHT, cylinder->getOverflow(newPosition) };
+            return true;
+        }
+    } else if (cylinder->isOutsideLeftZBoundary(newPosition)) {
+        if (leftConnection == nullptr) {
+            newPosition = cylinder->reflectParticle(position, newPosition);
+        } else {
+            *handoff = { Direction::LEFT, cylinder->getOverflow(newPosition) };
+            return true;
+        }
+    } else {
+        newPosition = reflectInside(*cylinder, position, newPosition);
+    }
+    particles.setPosition(index, newPosition);
+    return false;
 }
 
 std::vector<glm::dvec3> Simulation::getAliveParticlePositions() const
@@ -174,9 +489,7 @@ std::vector<glm::dvec3> Simulation::getAliveParticlePositions() const
     
     //put each position in it's place by getting it from the object
     for (int i = 0; i < particles.size(); ++i) {
-        if (particles[i].isAlive()) {
-            positions.emplace_back(particles[i].getPosition());
-        }
+        positions.emplace_back(particles.getPosition(i));
     }
     
     
@@ -185,34 +498,20 @@ std::vector<glm::dvec3> Simulation::getAliveParticlePositions() const
 
 double Simulation::getBoundaryRadius() const
 {
-    Cylinder* cylinderBoundary = dynamic_cast<Cylinder*>(boundary.get());
-    
-    // If boundary is of type Cylinder* the dynamic cast will return the pointer to the boundary
-    // Else it will return nullptr and we are checking that below
-    // So basically we are returning the radius of the cylinder boundary if it is a cylinder
-    // Else throwing an error, because we shouldn't have called this function
-    
-    if (cylinderBoundary) {
-        return cylinderBoundary->getRadius();
-    } else {
+    // Only cylinders have a radius and a height, so calling this for another boundary is a bug
+    if (!cylinder) {
         throw std::runtime_error("Boundary is not of type Cylinder.");
     }
+    return cylinder->getRadius();
 }
 
 double Simulation::getBoundaryHeight() const
 {
-    Cylinder* cylinderBoundary = dynamic_cast<Cylinder*>(boundary.get());
-    
-    // If boundary is of type Cylinder* the dynamic cast will return the pointer to the boundary
-    // Else it will return nullptr and we are checking that below
-    // So basically we are returning the height of the cylinder boundary if it is a cylinder
-    // Else throwing an error, because we shouldn't have called this function
-    
-    if (cylinderBoundary) {
-        return cylinderBoundary->getHeight();
-    } else {
+    // Only cylinders have a radius and a height, so calling this for another boundary is a bug
+    if (!cylinder) {
         throw std::runtime_error("Boundary is not of type Cylinder.");
     }
+    return cylinder->getHeight();
 }
 
 void Simulation::giveParticleToLeft(Particle* particle, double overflow)
@@ -235,9 +534,44 @@ void Simulation::giveParticleToRight(Particle* particle, double overflow)
     rightConnection->receiveParticle(particle, Direction::RIGHT, overflow);
 }
 
+void Simulation::handOff(const Handoff& handoff)
+{
+    if (deferHandoffs) {
+        outbox.push_back(handoff);
+        return;
+    }
+    
+    // Connections only use the side and the overflow, not the position the particle left from
+    Particle handedOff(0.0, 0.0, 0.0);
+    if (handoff.direction == Direction::LEFT) {
+        giveParticleToLeft(&handedOff, handoff.overflow);
+    } else {
+        giveParticleToRight(&handedOff, handoff.overflow);
+    }
+}
+
+void Simulation::flushOutbox()
+{
+    // Connections only use the side and the overflow, the position of a queued particle is not kept
+    Particle handedOff(0.0, 0.0, 0.0);
+    for (const Handoff& handoff : outbox) {
+        if (handoff.direction == Direction::LEFT) {
+            giveParticleToLeft(&handedOff, handoff.overflow);
+        } else {
+            giveParticleToRight(&handedOff, handoff.overflow);
+        }
+    }
+    outbox.clear();
+}
+
 void Simulation::receiveParticle(Particle* particle, Direction direction, double overflow)
 {
-    std::pair<double, double> xypair = generatePointInCircle(getBoundaryRadius());
+    if (deferHandoffs) {
+        inbox.push_back({ direction, overflow });
+        return;
+    }
+    
+    std::pair<double, double> xypair = generatePointInCircle(inletRandom, getBoundaryRadius());
     double zCoord = 0;
     if (direction == Direction::LEFT) {
         zCoord = -getBoundaryHeight() + overflow;
@@ -245,38 +579,64 @@ void Simulation::receiveParticle(Particle* particle, Direction direction, double
         zCoord = getBoundaryHeight() - overflow;
     }
     Particle newParticle(xypair.first, xypair.second, zCoord);
-    newParticle.setBoundary(boundary.get());
-    newParticle.setSimulation(this);
     addParticle(newParticle);
-    //aliveParticleCount++; //why the fuck is this not inside addParticle, im not going to change it because im afraid of breaking something. nvm changed it.
 }
 
-void Simulation::addParticle(const Particle& newParticle) {
+void Simulation::flushInbox()
+{
+    int count = static_cast<int>(inbox.size());
+    if (count == 0) {
+        return;
+    }
     
-    if (!inactiveIndices.empty()) {
-        int index = inactiveIndices.top();
-        inactiveIndices.pop();
-
-        // Ensure index is within valid bounds before accessing the vector
-        if (index >= 0 && index < particles.size()) {
-            particles[index] = newParticle;
-            particles[index].revive();
-        } else {
-            std::cerr << "!!!!!!!!!  Error: Retrieved invalid index from inactiveIndices. !!!!!!!!!!!!!\n";
-        }
-    } else {
-        // when I remove this part the big bug that I'm facing occurs.
-        // when the particles vector is empty and inactive indices is also empty
-        // it gives an error while trying to allocate new space for the vector
-        if (particles.capacity() == 0) {
-            particles.reserve(100);  // Adjust based on expected usage
-        }
-        particles.push_back(newParticle);
+    int first = particles.grow(count);
+    generatePointsInCircle(inletRandom, getBoundaryRadius(), particles.x() + first, particles.y() + first, count);
+    double height = getBoundaryHeight();
+    double* z = particles.z() + first;
+    for (int i = 0; i < count; ++i) {
+        const Handoff& arrival = inbox[i];
+        z[i] = arrival.direction == Direction::LEFT ? -height + arrival.overflow : height - arrival.overflow;
+    }
+    aliveParticleCount += count;
+    inbox.clear();
+}
+
+void Simulation::seedRandomStreams(uint64_t seed)
+{
+    motionRandom = RandomStream(seed, streamIdFromName(name + ":motion"));
+    inletRandom = RandomStream(seed, streamIdFromName(name + ":inlet"));
+}
+
+void Simulation::addParticle(const Particle& newParticle) {
+    // when I remove this part the big bug that I'm facing occurs.
+    // when the particles vector is empty it gives an error while trying to allocate new space for the vector
+    if (particles.capacity() == 0) {
+        particles.reserve(100);  // Adjust based on expected usage
     }
+    const glm::dvec3& position = newParticle.getPosition();
+    particles.add(position.x, position.y, position.z);
     
     aliveParticleCount++;
 }
 
+void Simulation::addParticles(const double* x, const double* y, const double* z, int count)
+{
+    int first = particles.grow(count);
+    std::copy(x, x + count, particles.x() + first);
+    std::copy(y, y + count, particles.y() + first);
+    std::copy(z, z + count, particles.z() + first);
+    aliveParticleCount += count;
+}
+
+void Simulation::addParticles(const glm::dvec3& position, int count)
+{
+    int first = particles.grow(count);
+    std::fill(particles.x() + first, particles.x() + first + count, position.x);
+    std::fill(particles.y() + first, particles.y() + first + count, position.y);
+    std::fill(particles.z() + first, particles.z() + first + count, position.z);
+    aliveParticleCount += count;
+}
+
 
 void Simulation::killParticle(int index) {
     if (index < 0 || index >= particles.size()) {
@@ -284,46 +644,13 @@ void Simulation::killParticle(int index) {
         return;
     }
 
-    if (!particles[index].isAlive()) {
-        std::cerr << "Warning: Trying to kill an already dead particle.\n";
-        return;
-    }
-
-    particles[index].kill();
-
-    // Push the killed particle's index into inactiveIndices for reuse
-    inactiveIndices.push(index);
+    particles.remove(index);
 
     aliveParticleCount--;
 }
 
 glm::dvec3 Simulation::getFlow(glm::dvec3 position) const{
-    
-    Cylinder* cylinderBoundary = dynamic_cast<Cylinder*>(boundary.get());
-    
-    // If boundary is of type Cylinder* the dynamic cast will return the pointer to the boundary
-    // Else it will return nullptr and we are checking that below
-    
-    if (cylinderBoundary) {
-        double x = position.x;
-        double y = position.y;
-        double z = position.z;
-        double R = cylinderBoundary->getRadius();
-        double rsquared;
-        int cylinderOrientation = cylinderBoundary->getOrientation();
-        if (cylinderOrientation == 0) {
-            rsquared = (y*y + z*z);
-        } else if(cylinderOrientation == 1){
-            rsquared = (x*x + z*z);
-        } else if(cylinderOrientation == 2){
-            rsquared = (x*x + y*y);
-        } else {
-            throw std::runtime_error("Saçma error");
-        }
-        return flow * (1-(rsquared)/(R*R));
-    } else {
-        throw std::runtime_error("Boundary is not of type Cylinder.");
-    }
+    return std::visit([&](auto* typed) { return flowAt(*typed, flow, position); }, typedBoundary);
 }
 
 void Simulation::receiversWrite(const std::string &baseDir) const {
@@ -10,55 +10,145 @@
 
 #include <stdio.h>
 #include <src/core/particle.hpp>
+#include <src/core/particleStore.hpp>
 #include <src/core/receivers/receiver.hpp>
 #include <src/core/emitters/emitter.hpp>
 #include <src/core/receivers/sphericalReceiver.hpp>
+#include <src/core/receivers/receiverIndex.hpp>
 #include <vector>
-#include <stack>
 #include <memory>
+#include <algorithm>
 #include <glm/vec3.hpp>
 #include <src/math/gaussian.hpp>
 #include <src/config/config.h>
+#include <src/config/simulationParameters.hpp>
 #include <src/config/unused/oldconfig.h>
 #include <src/core/boundaries/boundary.hpp>
+#include <src/core/boundaries/boundaryVariant.hpp>
 #include <stdexcept>
 #include <src/math/random.hpp>
+#include <src/math/randomStream.hpp>
 #include <src/core/connections/connection.hpp>
+#include <src/core/kernels/brownianKernel.hpp>
+#include <src/core/kernels/firstPassage.hpp>
 
 class Particle;
 
+// A particle that left the pipe through one of its ends during a step,
+// waiting to be given to the connection on that side
+struct Handoff {
+    Direction direction;
+    double overflow;
+};
+
+// What a range of particle blocks produced during one step. Ranges of the same pipe can be stepped
+// on different threads, their results are applied to the pipe afterwards, in block order, by finishStep
+struct StepResult {
+    std::vector<int> killed; // slots to free, in slot order (finishStep removes them last to first)
+    std::vector<Handoff> handoffs; // particles that left through an end, in slot order
+    std::vector<int> receiverHits; // hits per receiver
+    // Scratch of Simulation::testReceivers, kept here so it is allocated once per range and not per block
+    std::vector<int> bucketStart;
+    std::vector<int> bucketFill;
+    std::vector<int> bucketLanes;
+    
+    void reset(int receiverCount);
+};
+
 class Simulation: public Connection
 {
 private:
-    std::vector<Particle> particles;
-    std::stack<int> inactiveIndices; // Indices of inactive particles
+    ParticleStore particles; // the alive particles of this pipe, densely packed
     std::vector<std::unique_ptr<Receiver>> receivers;
+    ReceiverIndex receiverIndex; // receivers by z slab of the pipe, rebuilt by addReceiver
     std::vector<std::unique_ptr<Emitter>> emitters;
+    // Emitter clock: iterations run so far, and the earliest next event of the emitters. A SimulationNetwork
+    // fires the emitters of all its pipes from one event queue instead (emittersScheduled).
+    int64_t emissionStep = 0;
+    int64_t nextEmission = EmissionSchedule::NEVER;
+    bool emittersScheduled = false;
     int aliveParticleCount;
+    SimulationParameters parameters; // mode, time step, diffusion coefficient...
     std::unique_ptr<Boundary> boundary;
+    BoundaryVariant typedBoundary; // the same boundary with its concrete type
+    Cylinder* cylinder = nullptr; // the boundary when it is a cylinder (every network pipe)
     //gpt bu connectionları düz pointer olarak tutma weakptr sharedptr falan kullan diyo da bence gerek yok.
     Connection* leftConnection = nullptr;
     Connection* rightConnection = nullptr;
     glm::dvec3 flow;
     std::string name; // Name of the simulation (e.g., pipe0, pipe1)
     std::string parentName; // Name of the parent simulation (e.g., pipe0, pipe1)
+    RandomStream motionRandom; // Brownian displacements, seeked to (iteration, block) before each block
+    RandomStream inletRandom; // entry positions of received particles
+    // When deferHandoffs is set, particles leaving the pipe are queued here instead of being given
+    // to the neighbour immediately, so pipes can be stepped in parallel (see SimulationNetwork::iterateNetwork)
+    std::vector<Handoff> outbox;
+    bool deferHandoffs = false;
+    // Particles received from the connections (their side and overflow) and not added yet, see flushInbox
+    std::vector<Handoff> inbox;
+    
+    // State of the step in progress, set by beginStep
+    CylinderStepParams stepParams;
+    FirstPassageLimits firstPassageLimits;
+    int stepIterationNumber = 0;
+    int stepSlotCount = 0; // slots that existed when the step began
+    
+    template <class BoundaryT>
+    void setBoundary(std::unique_ptr<BoundaryT> newBoundary);
+    // MODE 0 loop, compiled separately for each boundary type
+    template <class BoundaryT>
+    void iterateSingle(const BoundaryT& typedBoundary, int iterationCount, int currentFrame, int iterationInCurrentFrame);
+    
+    // Runs the emitters due this iteration, unless emittersScheduled, and moves the emitter clock on
+    void fireEmitters();
+    void handOff(const Handoff& handoff);
+    // Reflects a particle whose step ends at newPosition, or fills handoff and returns true if it left through an end
+    bool resolveCylinderStep(int index, glm::dvec3 newPosition, Handoff* handoff);
+    // Tests count particles (final positions x/y/z, the ones with skip set excluded) against the receivers:
+    // the particles are bucketed per receiver through receiverIndex, then every receiver checks its bucket with one
+    // hitBatch call. Hits are added to result.receiverHits, absorbed[i] is set for particles an absorbing receiver took.
+    void testReceivers(const double* x, const double* y, const double* z,
+                       const uint8_t* skip, uint8_t* absorbed, int count, StepResult& result) const;
+    // Replaces the plain step of every particle that is clear enough by a first-passage jump (parameters.firstPassageJumps):
+    // its end point and outcome overwrite newX/newY/newZ/outcome and jumpSteps gets its length, 0 for the others.
+    // The jumps' normals are drawn from random after the block's step noise.
+    void takeFirstPassageJumps(RandomStream& random, const double* x, const double* y, const double* z,
+                               double* newX, double* newY, double* newZ, uint8_t* outcome, int* jumpSteps, int count) const;
     
 public:
     ~Simulation();
-    Simulation(int particleCount = PARTICLE_COUNT, double radius = SINGLE_CYLINDER_R, double length = SINGLE_CYLINDER_Z, glm::dvec3 flow = glm::dvec3(SINGLE_FLOW_X, SINGLE_FLOW_Y, SINGLE_FLOW_Z));
+    Simulation(int particleCount = PARTICLE_COUNT, double radius = SINGLE_CYLINDER_R, double length = SINGLE_CYLINDER_Z, glm::dvec3 flow = glm::dvec3(SINGLE_FLOW_X, SINGLE_FLOW_Y, SINGLE_FLOW_Z), const SimulationParameters& parameters = SimulationParameters());
     void iterateSimulation(int iterationCount, int currentFrame, int iterationInCurrentFrame = 0);
     
+    // One MODE 1 iteration split in three, so a network can spread a single pipe over several threads:
+    // beginStep runs the emitters and returns the number of particle blocks to step,
+    // stepBlocks moves the particles of blocks [firstBlock, endBlock) and only writes their slots and the result,
+    // finishStep applies the results of all the ranges, which must be passed in block order.
+    int beginStep(int currentFrame, int iterationInCurrentFrame);
+    void stepBlocks(int firstBlock, int endBlock, StepResult& result);
+    void finishStep(const StepResult* results, int resultCount);
+    
     void addParticle(const Particle& addParticle);
+    // Batch versions of addParticle: count particles at the given positions, or all at one position (emitters)
+    void addParticles(const double* x, const double* y, const double* z, int count);
+    void addParticles(const glm::dvec3& position, int count);
+    // Removes the particle in the given slot; the particle in the last slot moves into it
     void killParticle(int index);
+    // Moves the particle in the given slot against this simulation's boundary (was Particle::move)
+    void moveParticle(int index, double dx, double dy, double dz, bool* toBeKilled);
+    // Scalar slow path: resolves reflections and hand-offs for a particle whose step ends at newPosition
+    void moveParticleTo(int index, glm::dvec3 newPosition, bool* toBeKilled);
     
     std::vector<glm::dvec3> getAliveParticlePositions() const;
+    const ParticleStore& getParticles() const;
     int getAliveParticleCount() const;
     const std::vector<std::unique_ptr<Receiver>>& getReceivers() const;
+    // Also sizes the receiver's output for this simulation's time window and adds it to the receiver index
     void addReceiver(std::unique_ptr<Receiver> receiver);
     void receiversWrite(const std::string& path) const;
     void simulationDataWrite(const std::string& path) const;
     
-    bool checkReceivedForParticle(const Particle& particle, const Receiver& receiver) const;
+    bool checkReceivedForParticle(const glm::dvec3& particlePosition, const Receiver& receiver) const;
 
     double getBoundaryRadius() const; // should only be called when boundary type is cylinder
     double getBoundaryHeight() const; // should only be called when boundary type is cylinder
@@ -67,28 +157,54 @@ public:
     void giveParticleToRight(Particle* particle, double overflow);
     void receiveParticle(Particle* particle, Direction direction, double overflow) override;
     
+    // Deferred simulations also hold the particles they receive until flushInbox
+    void setDeferHandoffs(bool defer);
+    // Gives every queued particle to its connection, in the order they left
+    void flushOutbox();
+    // Adds every particle received since the last flush, in the order they arrived, with their entry positions
+    // drawn in one batch. beginStep flushes first, so received particles are never left out of a step.
+    void flushInbox();
+    
     void setLeftConnection(Connection* connection);
     void setRightConnection(Connection* connection);
     Connection* getLeftConnection() const;
     Connection* getRightConnection() const;
     
     glm::dvec3 getFlow(glm::dvec3 position) const;
+    // Centreline flow velocity (the flow solver sets it after the pipes are built)
+    void setFlow(const glm::dvec3& flow);
     
     void addEmitter(std::unique_ptr<Emitter> emitter);
     const std::vector<std::unique_ptr<Emitter>>& getEmitters() const;
+    // Set by SimulationNetwork, which then runs the emitters itself
+    void setEmittersScheduled(bool scheduled);
     
     Boundary* getBoundary() const;
+    const SimulationParameters& getParameters() const;
     
     // Name getter and setter
     void setName(const std::string& simulationName);
     const std::string& getName() const;
     void setParentName(const std::string& parentName);
+    // Derives this pipe's streams from the run seed and the pipe name, so call it after setName
+    void seedRandomStreams(uint64_t seed);
     const std::string& getParentName() const;
 };
 
 inline const std::vector<std::unique_ptr<Receiver>>& Simulation::getReceivers() const { return receivers; }
-inline void Simulation::addReceiver(std::unique_ptr<Receiver> receiver) { receivers.push_back(std::move(receiver)); }
+inline void Simulation::addReceiver(std::unique_ptr<Receiver> receiver) {
+    receiver->setTimeWindow(parameters.getIterationCount(), parameters.dt);
+    receivers.push_back(std::move(receiver));
+    if (cylinder) {
+        receiverIndex.build(receivers, -cylinder->getHeight(), cylinder->getHeight());
+    }
+}
 inline int Simulation::getAliveParticleCount() const { return aliveParticleCount; }
+inline const ParticleStore& Simulation::getParticles() const { return particles; }
+
+inline void Simulation::setDeferHandoffs(bool defer) { deferHandoffs = defer; }
+
+inline void Simulation::setFlow(const glm::dvec3& flow) { this->flow = flow; }
 
 inline void Simulation::setLeftConnection(Connection *connection){ leftConnection = connection; }
 inline void Simulation::setRightConnection(Connection *connection){ rightConnection = connection; }
@@ -96,8 +212,10 @@ inline Connection* Simulation::getLeftConnection() const{ return leftConnection;
 inline Connection* Simulation::getRightConnection() const{ return rightConnection; }
 
 inline Boundary* Simulation::getBoundary() const { return boundary.get(); }
+inline const SimulationParameters& Simulation::getParameters() const { return parameters; }
 
 inline void Simulation::addEmitter(std::unique_ptr<Emitter> emitter) {
+    nextEmission = std::min(nextEmission, emitter->getNextEmission());
     emitters.push_back(std::move(emitter));
 }
 
@@ -105,6 +223,8 @@ inline const std::vector<std::unique_ptr<Emitter>>& Simulation::getEmitters() co
     return emitters;
 }
 
+inline void Simulation::setEmittersScheduled(bool scheduled) { emittersScheduled = scheduled; }
+
 inline void Simulation::setName(const std::string& simulationName) {
     name = simulationName;
 }
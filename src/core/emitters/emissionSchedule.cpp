@@ -0,0 +1,129 @@
+//
+//  emissionSchedule.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "emissionSchedule.hpp"
+#include <src/math/poisson.hpp>
+#include <cmath>
+#include <algorithm>
+
+EmissionSchedule::EmissionSchedule() {}
+
+EmissionSchedule EmissionSchedule::pattern(const std::vector<int>& pattern, bool repeat)
+{
+    EmissionSchedule schedule;
+    schedule.kind = EmissionKind::PATTERN;
+    for (int i = 0; i < (int)pattern.size(); ++i) {
+        if (pattern[i] > 0) {
+            schedule.offsets.push_back(i);
+            schedule.counts.push_back(pattern[i]);
+        }
+    }
+    schedule.period = repeat ? static_cast<int64_t>(pattern.size()) : 0;
+    if (!schedule.offsets.empty()) {
+        schedule.eventStep = schedule.offsets[0];
+        schedule.eventCount = schedule.counts[0];
+    }
+    return schedule;
+}
+
+EmissionSchedule EmissionSchedule::poisson(double rate, double start, double stop, double dt, const RandomStream& random)
+{
+    EmissionSchedule schedule;
+    schedule.kind = EmissionKind::POISSON;
+    schedule.mean = rate * dt;
+    schedule.stopStep = stop > 0.0 ? std::llround(stop / dt) : NEVER;
+    schedule.random = random;
+    if (schedule.mean > 0.0) {
+        // Start one step early, advance moves on to the first iteration that releases something
+        schedule.eventStep = std::llround(std::max(start, 0.0) / dt) - 1;
+        schedule.advance();
+    }
+    return schedule;
+}
+
+EmissionSchedule EmissionSchedule::pulseTrain(int count, double start, double period, int pulses, double dt)
+{
+    EmissionSchedule schedule;
+    schedule.kind = EmissionKind::PULSE_TRAIN;
+    schedule.pulseCount = count;
+    schedule.firstPulse = std::max(start, 0.0) / dt;
+    schedule.pulseSpacing = period / dt;
+    // Without a period every pulse is at start
+    schedule.pulseLimit = period > 0.0 ? pulses : std::max(pulses, 1);
+    if (count > 0) {
+        schedule.advance();
+    }
+    return schedule;
+}
+
+int64_t EmissionSchedule::pulseStep(int64_t pulse) const
+{
+    return std::llround(firstPulse + pulse * pulseSpacing);
+}
+
+int64_t EmissionSchedule::pulsesAt(int64_t step) const
+{
+    // Pulses that round to the same iteration go out together: they are the ones up to the first pulse at or past
+    // step + 1/2, found in closed form so a train much denser than the iterations does not loop over its pulses
+    int64_t end = pulseLimit > 0 ? pulseLimit : (int64_t(1) << 62);
+    if (pulseSpacing <= 0.0) {
+        return end; // no period, every pulse is at the first one
+    }
+    double estimate = std::ceil((double(step) + 0.5 - firstPulse) / pulseSpacing);
+    int64_t next = std::max(pulseIndex + 1, static_cast<int64_t>(std::min(estimate, double(end))));
+    // The division can land one pulse off around the rounding boundary
+    while (next > pulseIndex + 1 && pulseStep(next - 1) != step) {
+        next--;
+    }
+    while (next < end && pulseStep(next) == step) {
+        next++;
+    }
+    return std::min(next, end);
+}
+
+void EmissionSchedule::advance()
+{
+    switch (kind) {
+        case EmissionKind::PATTERN:
+            if (++entry == offsets.size()) {
+                if (period == 0) {
+                    eventStep = NEVER;
+                    return;
+                }
+                entry = 0;
+                cycleStart += period;
+            }
+            eventStep = cycleStart + offsets[entry];
+            eventCount = counts[entry];
+            break;
+            
+        case EmissionKind::POISSON: {
+            // Iterations are empty with probability e^-mean, so the run of empty ones before the next event is
+            // geometric: floor(log(u) / -mean)
+            double skipped = std::floor(std::log1p(-random.nextUniform()) / -mean);
+            if (double(eventStep) + 1.0 + skipped >= double(stopStep)) {
+                eventStep = NEVER;
+                return;
+            }
+            eventStep += 1 + static_cast<int64_t>(skipped);
+            eventCount = generatePositivePoisson(random, mean);
+            break;
+        }
+            
+        case EmissionKind::PULSE_TRAIN: {
+            if (pulseLimit > 0 && pulseIndex >= pulseLimit) {
+                eventStep = NEVER;
+                return;
+            }
+            eventStep = pulseStep(pulseIndex);
+            int64_t next = pulsesAt(eventStep);
+            eventCount = static_cast<int>((next - pulseIndex) * pulseCount);
+            pulseIndex = next;
+            break;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+//
+//  emissionSchedule.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef emissionSchedule_hpp
+#define emissionSchedule_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <src/math/randomStream.hpp>
+
+enum class EmissionKind : uint8_t {
+    PATTERN, // emitter_pattern: one count per iteration, cycled or played once
+    POISSON, // a constant rate, with Poisson distributed counts
+    PULSE_TRAIN // the same count at regular times
+};
+
+// When an emitter releases particles and how many, compiled at load time into a sequence of events (step, count)
+// with increasing steps, where a step is the number of iterations run before it (0 is the first iteration).
+// Only iterations that release something become events, so an emitter costs nothing between its events:
+// patterns keep their non-zero entries, Poisson emitters jump over their empty iterations with one geometric draw,
+// and pulse trains compute the step of their next pulse.
+class EmissionSchedule
+{
+private:
+    EmissionKind kind = EmissionKind::PATTERN;
+
+    // PATTERN: the non-zero entries as (offset in the pattern, count), repeated every period steps (0: played once)
+    std::vector<int> offsets;
+    std::vector<int> counts;
+    int64_t period = 0;
+    size_t entry = 0;
+    int64_t cycleStart = 0;
+
+    // POISSON: mean count per iteration, in steps [first step, stopStep)
+    double mean = 0.0;
+    int64_t stopStep = 0;
+    RandomStream random;
+
+    // PULSE_TRAIN: pulse i is at step round(firstPulse + i * pulseSpacing), for i below pulseLimit (0: no limit)
+    int pulseCount = 0;
+    double firstPulse = 0.0;
+    double pulseSpacing = 0.0;
+    int pulseLimit = 0;
+    int64_t pulseIndex = 0;
+
+    int64_t eventStep = NEVER;
+    int eventCount = 0;
+
+    int64_t pulseStep(int64_t pulse) const;
+    // Index of the first pulse after pulseIndex that is not at step
+    int64_t pulsesAt(int64_t step) const;
+
+public:
+    static constexpr int64_t NEVER = std::numeric_limits<int64_t>::max();
+
+    // An empty schedule, that never emits
+    EmissionSchedule();
+    // The emitter_pattern counts, one per iteration; once through, or cycled when repeat is set
+    static EmissionSchedule pattern(const std::vector<int>& pattern, bool repeat);
+    // rate particles per second from start to stop seconds (stop <= 0: no end), with iterations of dt seconds
+    static EmissionSchedule poisson(double rate, double start, double stop, double dt, const RandomStream& random);
+    // count particles every period seconds from start, pulses times (0: no limit), with iterations of dt seconds.
+    // Pulses closer than an iteration are released together. An unlimited train needs period >= dt.
+    static EmissionSchedule pulseTrain(int count, double start, double period, int pulses, double dt);
+
+    // Step and count of the next event, NEVER once the schedule is over
+    int64_t nextStep() const;
+    int nextCount() const;
+    // Moves on to the event after it
+    void advance();
+};
+
+inline int64_t EmissionSchedule::nextStep() const { return eventStep; }
+inline int EmissionSchedule::nextCount() const { return eventCount; }
+
+#endif /* emissionSchedule_hpp */
@@ -9,42 +9,37 @@
 #define emitter_hpp
 
 #include <stdio.h>
-#include <vector>
-#include <string>
+#include <cstdint>
 #include "glm/glm.hpp"
+#include <src/core/emitters/emissionSchedule.hpp>
 
 class Simulation;
-class Particle;
 
 class Emitter {
 private:
     glm::dvec3 position;
-    std::vector<int> emissionPattern;
-    size_t currentPatternIndex;
+    EmissionSchedule schedule; // when to emit and how many, compiled at load time
     Simulation* simulation;
-    std::string patternType; // "repeat" or "complete"
-    bool patternCompleted;
     int totalEmitted; // Total number of particles emitted
     
 public:
-    Emitter(glm::dvec3 position, const std::vector<int>& pattern, Simulation* simulation, const std::string& patternType);
+    Emitter(glm::dvec3 position, EmissionSchedule schedule, Simulation* simulation);
     
-    void emit(int currentFrame);
+    // Adds the particles of every event of the schedule up to step (the number of iterations run before this one)
+    void emitDue(int64_t step);
+    // Step of the next event, EmissionSchedule::NEVER when the emitter is done
+    int64_t getNextEmission() const;
+    // What is left of the schedule, impulse-response synthesis replays a copy of it
+    const EmissionSchedule& getSchedule() const;
     
     glm::dvec3 getPosition() const;
     void setPosition(const glm::dvec3& pos);
     
-    const std::vector<int>& getEmissionPattern() const;
-    void setEmissionPattern(const std::vector<int>& pattern);
-    
-    const std::string& getPatternType() const;
-    void setPatternType(const std::string& type);
-    
-    bool isPatternCompleted() const;
-    void resetPattern();
-    
     // Getter for total emitted particles
     int getTotalEmitted() const;
 };
 
+inline int64_t Emitter::getNextEmission() const { return schedule.nextStep(); }
+inline const EmissionSchedule& Emitter::getSchedule() const { return schedule; }
+
 #endif /* emitter_hpp */
@@ -0,0 +1,283 @@
+//
+//  brownianKernel.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "brownianKernel.hpp"
+#include <src/math/circleReflection.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define BROWNIAN_KERNEL_X86 1
+#include <immintrin.h>
+#else
+#define BROWNIAN_KERNEL_X86 0
+#endif
+
+namespace {
+
+typedef void (*AdvanceFunction)(const CylinderStepParams&, const double*, const double*, const double*,
+                                const double*, double*, double*, double*, uint8_t*, int);
+
+inline uint8_t classify(double newX, double newY, double newZ, double zLimit, double radiusSquared)
+{
+    // The z checks come first, matching the order of the slow path in Simulation::moveParticle
+    if (newZ > zLimit) return STEP_OUTSIDE_RIGHT;
+    if (newZ < -zLimit) return STEP_OUTSIDE_LEFT;
+    if (std::fma(newX, newX, newY * newY) > radiusSquared) return STEP_OUTSIDE_WALL;
+    return STEP_INSIDE;
+}
+
+// Plain loop, also used for the tail of the vector implementations. Every sum is the same explicit fma as in the
+// vector code, so a particle's step is the same bits whichever implementation or lane computes it (std::fma is
+// never split or merged by the compiler, unlike a * b + c under -ffp-contract).
+void advanceScalar(const CylinderStepParams& p, const double* x, const double* y, const double* z,
+                   const double* noise, double* newX, double* newY, double* newZ, uint8_t* outcome, int count)
+{
+    const double* nx = noise;
+    const double* ny = noise + count;
+    const double* nz = noise + 2 * count;
+    double radiusSquared = p.radius * p.radius;
+    double invRadiusSquared = 1.0 / radiusSquared;
+
+    for (int i = 0; i < count; ++i) {
+        double rsq = std::fma(x[i], x[i], y[i] * y[i]);
+        double profile = std::fma(-rsq, invRadiusSquared, 1.0) * p.dt;
+        newX[i] = std::fma(nx[i], p.sigma, std::fma(p.flowX, profile, x[i]));
+        newY[i] = std::fma(ny[i], p.sigma, std::fma(p.flowY, profile, y[i]));
+        newZ[i] = std::fma(nz[i], p.sigma, std::fma(p.flowZ, profile, z[i]));
+        outcome[i] = classify(newX[i], newY[i], newZ[i], p.zLimit, radiusSquared);
+    }
+}
+
+#if BROWNIAN_KERNEL_X86
+
+// Turns the three lane masks into per-particle outcomes with the same priority as classify()
+inline void writeOutcomes(uint8_t* outcome, int lanes, unsigned rightMask, unsigned leftMask, unsigned wallMask)
+{
+    for (int l = 0; l < lanes; ++l) {
+        unsigned bit = 1u << l;
+        outcome[l] = (rightMask & bit) ? STEP_OUTSIDE_RIGHT
+                   : (leftMask & bit)  ? STEP_OUTSIDE_LEFT
+                   : (wallMask & bit)  ? STEP_OUTSIDE_WALL
+                   : STEP_INSIDE;
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void advanceAvx2(const CylinderStepParams& p, const double* x, const double* y, const double* z,
+                 const double* noise, double* newX, double* newY, double* newZ, uint8_t* outcome, int count)
+{
+    const double* nx = noise;
+    const double* ny = noise + count;
+    const double* nz = noise + 2 * count;
+    double radiusSquared = p.radius * p.radius;
+
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d invR2 = _mm256_set1_pd(1.0 / radiusSquared);
+    const __m256d r2 = _mm256_set1_pd(radiusSquared);
+    const __m256d zMax = _mm256_set1_pd(p.zLimit);
+    const __m256d zMin = _mm256_set1_pd(-p.zLimit);
+    const __m256d sigma = _mm256_set1_pd(p.sigma);
+    const __m256d dt = _mm256_set1_pd(p.dt);
+    const __m256d fx = _mm256_set1_pd(p.flowX);
+    const __m256d fy = _mm256_set1_pd(p.flowY);
+    const __m256d fz = _mm256_set1_pd(p.flowZ);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d vx = _mm256_loadu_pd(x + i);
+        __m256d vy = _mm256_loadu_pd(y + i);
+        __m256d vz = _mm256_loadu_pd(z + i);
+
+        __m256d rsq = _mm256_fmadd_pd(vx, vx, _mm256_mul_pd(vy, vy));
+        __m256d profile = _mm256_mul_pd(_mm256_fnmadd_pd(rsq, invR2, one), dt);
+
+        __m256d ox = _mm256_fmadd_pd(_mm256_loadu_pd(nx + i), sigma, _mm256_fmadd_pd(fx, profile, vx));
+        __m256d oy = _mm256_fmadd_pd(_mm256_loadu_pd(ny + i), sigma, _mm256_fmadd_pd(fy, profile, vy));
+        __m256d oz = _mm256_fmadd_pd(_mm256_loadu_pd(nz + i), sigma, _mm256_fmadd_pd(fz, profile, vz));
+
+        _mm256_storeu_pd(newX + i, ox);
+        _mm256_storeu_pd(newY + i, oy);
+        _mm256_storeu_pd(newZ + i, oz);
+
+        __m256d newRsq = _mm256_fmadd_pd(ox, ox, _mm256_mul_pd(oy, oy));
+        unsigned right = _mm256_movemask_pd(_mm256_cmp_pd(oz, zMax, _CMP_GT_OQ));
+        unsigned left = _mm256_movemask_pd(_mm256_cmp_pd(oz, zMin, _CMP_LT_OQ));
+        unsigned wall = _mm256_movemask_pd(_mm256_cmp_pd(newRsq, r2, _CMP_GT_OQ));
+
+        if ((right | left | wall) == 0) {
+            // The common case: the whole group stays inside
+            outcome[i] = outcome[i + 1] = outcome[i + 2] = outcome[i + 3] = STEP_INSIDE;
+        } else {
+            writeOutcomes(outcome + i, 4, right, left, wall);
+        }
+    }
+
+    // Leave the upper vector state clean before running scalar code (the tail here, libm right after us).
+    // The compiler does not always emit this on the tail path, and a dirty upper state makes every
+    // following SSE instruction pay a transition penalty.
+    _mm256_zeroupper();
+
+    if (i < count) {
+        // The noise array is indexed by count, so hand the tail over with a matching layout
+        double tailNoise[3 * 4];
+        int tail = count - i;
+        for (int k = 0; k < tail; ++k) {
+            tailNoise[k] = nx[i + k];
+            tailNoise[tail + k] = ny[i + k];
+            tailNoise[2 * tail + k] = nz[i + k];
+        }
+        advanceScalar(p, x + i, y + i, z + i, tailNoise, newX + i, newY + i, newZ + i, outcome + i, tail);
+    }
+}
+
+__attribute__((target("avx512f")))
+void advanceAvx512(const CylinderStepParams& p, const double* x, const double* y, const double* z,
+                   const double* noise, double* newX, double* newY, double* newZ, uint8_t* outcome, int count)
+{
+    const double* nx = noise;
+    const double* ny = noise + count;
+    const double* nz = noise + 2 * count;
+    double radiusSquared = p.radius * p.radius;
+
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d invR2 = _mm512_set1_pd(1.0 / radiusSquared);
+    const __m512d r2 = _mm512_set1_pd(radiusSquared);
+    const __m512d zMax = _mm512_set1_pd(p.zLimit);
+    const __m512d zMin = _mm512_set1_pd(-p.zLimit);
+    const __m512d sigma = _mm512_set1_pd(p.sigma);
+    const __m512d dt = _mm512_set1_pd(p.dt);
+    const __m512d fx = _mm512_set1_pd(p.flowX);
+    const __m512d fy = _mm512_set1_pd(p.flowY);
+    const __m512d fz = _mm512_set1_pd(p.flowZ);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512d vx = _mm512_loadu_pd(x + i);
+        __m512d vy = _mm512_loadu_pd(y + i);
+        __m512d vz = _mm512_loadu_pd(z + i);
+
+        __m512d rsq = _mm512_fmadd_pd(vx, vx, _mm512_mul_pd(vy, vy));
+        __m512d profile = _mm512_mul_pd(_mm512_fnmadd_pd(rsq, invR2, one), dt);
+
+        __m512d ox = _mm512_fmadd_pd(_mm512_loadu_pd(nx + i), sigma, _mm512_fmadd_pd(fx, profile, vx));
+        __m512d oy = _mm512_fmadd_pd(_mm512_loadu_pd(ny + i), sigma, _mm512_fmadd_pd(fy, profile, vy));
+        __m512d oz = _mm512_fmadd_pd(_mm512_loadu_pd(nz + i), sigma, _mm512_fmadd_pd(fz, profile, vz));
+
+        _mm512_storeu_pd(newX + i, ox);
+        _mm512_storeu_pd(newY + i, oy);
+        _mm512_storeu_pd(newZ + i, oz);
+
+        __m512d newRsq = _mm512_fmadd_pd(ox, ox, _mm512_mul_pd(oy, oy));
+        unsigned right = _mm512_cmp_pd_mask(oz, zMax, _CMP_GT_OQ);
+        unsigned left = _mm512_cmp_pd_mask(oz, zMin, _CMP_LT_OQ);
+        unsigned wall = _mm512_cmp_pd_mask(newRsq, r2, _CMP_GT_OQ);
+
+        if ((right | left | wall) == 0) {
+            for (int l = 0; l < 8; ++l) outcome[i + l] = STEP_INSIDE;
+        } else {
+            writeOutcomes(outcome + i, 8, right, left, wall);
+        }
+    }
+
+    _mm256_zeroupper(); // see advanceAvx2
+
+    if (i < count) {
+        double tailNoise[3 * 8];
+        int tail = count - i;
+        for (int k = 0; k < tail; ++k) {
+            tailNoise[k] = nx[i + k];
+            tailNoise[tail + k] = ny[i + k];
+            tailNoise[2 * tail + k] = nz[i + k];
+        }
+        advanceScalar(p, x + i, y + i, z + i, tailNoise, newX + i, newY + i, newZ + i, outcome + i, tail);
+    }
+}
+
+#endif
+
+struct KernelChoice {
+    AdvanceFunction function;
+    const char* name;
+};
+
+KernelChoice chooseKernel()
+{
+#if BROWNIAN_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return { advanceAvx512, "avx512" };
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return { advanceAvx2, "avx2" };
+    }
+#endif
+    return { advanceScalar, "scalar" };
+}
+
+const KernelChoice& selectedKernel()
+{
+    // Resolved once, on first use
+    static const KernelChoice choice = chooseKernel();
+    return choice;
+}
+
+} // end anonymous namespace
+
+void advanceCylinderBlock(const CylinderStepParams& params,
+                          const double* x, const double* y, const double* z,
+                          const double* noise,
+                          double* newX, double* newY, double* newZ,
+                          uint8_t* outcome, int count)
+{
+    selectedKernel().function(params, x, y, z, noise, newX, newY, newZ, outcome, count);
+}
+
+void reflectWallCrossings(const CylinderStepParams& params,
+                          const double* x, const double* y,
+                          double* newX, double* newY,
+                          uint8_t* outcome, int count)
+{
+    // Gather the wall crossings so the reflection runs over contiguous arrays
+    int lanes[BROWNIAN_BLOCK_SIZE];
+    double startX[BROWNIAN_BLOCK_SIZE];
+    double startY[BROWNIAN_BLOCK_SIZE];
+    double endX[BROWNIAN_BLOCK_SIZE];
+    double endY[BROWNIAN_BLOCK_SIZE];
+
+    for (int offset = 0; offset < count; offset += BROWNIAN_BLOCK_SIZE) {
+        int end = std::min(offset + BROWNIAN_BLOCK_SIZE, count);
+        int wallCount = 0;
+        for (int i = offset; i < end; ++i) {
+            if (outcome[i] == STEP_OUTSIDE_WALL) {
+                lanes[wallCount] = i;
+                startX[wallCount] = x[i];
+                startY[wallCount] = y[i];
+                endX[wallCount] = newX[i];
+                endY[wallCount] = newY[i];
+                wallCount++;
+            }
+        }
+        if (wallCount == 0) {
+            continue;
+        }
+
+        reflectInsideCircleBatch(startX, startY, endX, endY, wallCount, params.radius);
+
+        for (int w = 0; w < wallCount; ++w) {
+            int i = lanes[w];
+            newX[i] = endX[w];
+            newY[i] = endY[w];
+            outcome[i] = STEP_INSIDE;
+        }
+    }
+}
+
+const char* brownianKernelName()
+{
+    return selectedKernel().name;
+}
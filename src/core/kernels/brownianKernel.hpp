@@ -0,0 +1,59 @@
+//
+//  brownianKernel.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef brownianKernel_hpp
+#define brownianKernel_hpp
+
+#include <stdio.h>
+#include <cstdint>
+
+// Number of particle slots advanced per kernel call.
+// Simulation walks its ParticleStore in blocks of this size.
+#define BROWNIAN_BLOCK_SIZE 256
+
+// Where a particle ended up after a kernel step.
+// STEP_OUTSIDE_WALL is resolved in batch by reflectWallCrossings, the two ends go through the scalar path in
+// Simulation (end reflection or hand-off).
+enum StepOutcome : uint8_t {
+    STEP_INSIDE = 0,
+    STEP_OUTSIDE_WALL = 1,
+    STEP_OUTSIDE_RIGHT = 2,
+    STEP_OUTSIDE_LEFT = 3
+};
+
+// Everything the kernel needs to know about a z-oriented cylinder pipe (MODE 1)
+struct CylinderStepParams {
+    double radius;
+    double zLimit;
+    double flowX;
+    double flowY;
+    double flowZ;
+    double dt;
+    double sigma; // sqrt(2 * D * DT)
+};
+
+// Advances count particles by one Brownian step with Poiseuille drift flow * (1 - r^2/R^2).
+// noise holds 3 * count standard normals laid out as [x normals | y normals | z normals].
+// New positions go to newX/newY/newZ, the store itself is not touched.
+// Dispatches at runtime to an AVX-512, AVX2 or scalar implementation.
+void advanceCylinderBlock(const CylinderStepParams& params,
+                          const double* x, const double* y, const double* z,
+                          const double* noise,
+                          double* newX, double* newY, double* newZ,
+                          uint8_t* outcome, int count);
+
+// Reflects the STEP_OUTSIDE_WALL particles of a kernel step back inside the cylinder in one batch
+// and marks them STEP_INSIDE. x/y are the positions before the step, newX/newY are updated in place.
+void reflectWallCrossings(const CylinderStepParams& params,
+                          const double* x, const double* y,
+                          double* newX, double* newY,
+                          uint8_t* outcome, int count);
+
+// Name of the implementation advanceCylinderBlock dispatches to ("avx512", "avx2" or "scalar")
+const char* brownianKernelName();
+
+#endif /* brownianKernel_hpp */
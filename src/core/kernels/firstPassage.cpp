@@ -0,0 +1,116 @@
+//
+//  firstPassage.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "firstPassage.hpp"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// Shorter jumps save too little over stepping to be worth their extra normals
+const int FIRST_PASSAGE_MIN_STEPS = 4;
+
+// Largest k with safety * sigma * sqrt(k) + drift * k <= gap: the walk of k steps keeps a margin of
+// safety standard deviations to the gap while drifting at most drift per step
+double largestHorizon(double gap, double safety, double sigma, double drift)
+{
+    if (!(gap > 0.0)) {
+        return 0.0;
+    }
+    double a = safety * sigma;
+    if (drift <= 0.0) {
+        double root = gap / a;
+        return root * root;
+    }
+    // drift * s^2 + a * s - gap = 0 for s = sqrt(k)
+    double root = (-a + std::sqrt(a * a + 4.0 * drift * gap)) / (2.0 * drift);
+    return root * root;
+}
+
+// Largest drift per step along z: what the flow reaches at the smallest radius the particle can get to
+// before it hits the wall
+double fastestDrift(const CylinderStepParams& p, double r)
+{
+    double rMin = std::max(2.0 * r - p.radius, 0.0);
+    return std::abs(p.flowZ) * (1.0 - rMin * rMin / (p.radius * p.radius)) * p.dt;
+}
+
+int clampSteps(double steps, const FirstPassageLimits& limits)
+{
+    steps = std::min(steps, double(limits.maxSteps));
+    return steps >= FIRST_PASSAGE_MIN_STEPS ? static_cast<int>(steps) : 0;
+}
+
+} // end anonymous namespace
+
+int firstPassageSteps(const CylinderStepParams& p, const FirstPassageLimits& limits,
+                      double x, double y, double z, double receiverClearance)
+{
+    if (p.flowX != 0.0 || p.flowY != 0.0) {
+        return 0;
+    }
+    
+    double r = std::sqrt(x * x + y * y);
+    double wallGap = p.radius - r;
+    double axialGap = std::min(p.zLimit - std::abs(z), receiverClearance);
+    
+    // Sideways each axis may go wallGap / sqrt(2), so the particle stays off the wall
+    double lateral = largestHorizon(wallGap * std::sqrt(0.5), limits.safety, p.sigma, 0.0);
+    
+    double axial = largestHorizon(axialGap, limits.safety, p.sigma, fastestDrift(p, r));
+    
+    return clampSteps(std::min(lateral, axial), limits);
+}
+
+double firstPassageReach(const CylinderStepParams& p, const FirstPassageLimits& limits,
+                         double x, double y, int steps)
+{
+    // Each axis within the safety bound puts the noise within sqrt(3) times it
+    double k = steps;
+    double r = std::sqrt(x * x + y * y);
+    return std::sqrt(3.0) * limits.safety * p.sigma * std::sqrt(k) + fastestDrift(p, r) * k;
+}
+
+int firstPassageStepsWithin(const CylinderStepParams& p, const FirstPassageLimits& limits,
+                            double x, double y, double distance)
+{
+    double r = std::sqrt(x * x + y * y);
+    return clampSteps(largestHorizon(distance, std::sqrt(3.0) * limits.safety, p.sigma, fastestDrift(p, r)), limits);
+}
+
+uint8_t firstPassageJump(const CylinderStepParams& p, double x, double y, double z, int steps,
+                         const double* normals, double& newX, double& newY, double& newZ)
+{
+    double k = steps;
+    double invRadiusSquared = 1.0 / (p.radius * p.radius);
+    
+    // With W_i the noise after i steps: the end point W_k, and S = W_0 + ... + W_(k-1), which the drift sums
+    // over. Both are Gaussian: Var W_k = k sigma^2, Cov(W_k, S) = k(k-1)/2 sigma^2 and S given W_k has variance
+    // (k-1)k(k+1)/12 sigma^2
+    double endSpread = p.sigma * std::sqrt(k);
+    double sumSpread = p.sigma * std::sqrt((k - 1.0) * k * (k + 1.0) / 12.0);
+    double wx = endSpread * normals[0];
+    double sx = wx * (k - 1.0) / 2.0 + sumSpread * normals[1];
+    double wy = endSpread * normals[2];
+    double sy = wy * (k - 1.0) / 2.0 + sumSpread * normals[3];
+    double wz = endSpread * normals[4];
+    
+    // sum over the steps of (1 - r_i^2 / R^2) dt, with r_i^2 = r^2 + 2 (x W_i + y W_i) + |W_i|^2 and
+    // the last term replaced by its mean i * 2 sigma^2
+    double profile = (k * (1.0 - (x * x + y * y) * invRadiusSquared)
+                      - 2.0 * (x * sx + y * sy) * invRadiusSquared
+                      - p.sigma * p.sigma * k * (k - 1.0) * invRadiusSquared) * p.dt;
+    
+    newX = x + wx;
+    newY = y + wy;
+    newZ = z + wz + p.flowZ * profile;
+    
+    if (newZ > p.zLimit) return STEP_OUTSIDE_RIGHT;
+    if (newZ < -p.zLimit) return STEP_OUTSIDE_LEFT;
+    if (newX * newX + newY * newY > p.radius * p.radius) return STEP_OUTSIDE_WALL;
+    return STEP_INSIDE;
+}
@@ -0,0 +1,54 @@
+//
+//  firstPassage.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef firstPassage_hpp
+#define firstPassage_hpp
+
+#include <stdio.h>
+#include <cstdint>
+#include "brownianKernel.hpp"
+
+// First-passage jumps (SimulationParameters::firstPassageJumps, FIRST_PASSAGE_JUMPS in config.h by default).
+// A particle far from the wall, the pipe ends and every receiver cannot touch any of them for a while, so the
+// DT steps until then change nothing but its position. Those steps are replaced by one jump: the number of steps
+// comes from a first-passage bound (the largest horizon over which the walk leaves its clearance with a
+// probability below safety standard deviations, drift included), and the end point is drawn
+// from the joint distribution of the steps it replaces. For the noise that is exact; the Poiseuille drift
+// depends on the path through r^2, and its part that is linear in the path is sampled exactly together with
+// the end point while the quadratic part is replaced by its mean.
+// Only axial flow is supported, pipes with a lateral flow component never jump.
+
+// How cautious the jumps are, from the simulation parameters
+struct FirstPassageLimits {
+    double safety;  // standard deviations of a jump's walk that must fit in its clearance
+    int maxSteps;   // longest jump, in DT steps
+};
+
+// Number of DT steps a particle at (x, y, z) may jump over, 0 if it should take a plain step.
+// receiverClearance is ReceiverIndex::axialClearance at z, or infinity to bound by the wall and the ends alone.
+int firstPassageSteps(const CylinderStepParams& params, const FirstPassageLimits& limits,
+                      double x, double y, double z, double receiverClearance);
+
+// How far, in any direction, a jump of steps DT steps may carry a particle at (x, y): only its distance from the
+// axis matters, through the drift it can pick up
+double firstPassageReach(const CylinderStepParams& params, const FirstPassageLimits& limits,
+                         double x, double y, int steps);
+
+// Number of DT steps whose reach from (x, y) fits in distance, 0 if too few to jump.
+// With distance the clearance to every receiver (ReceiverIndex::clearance), no receiver can be hit during them.
+int firstPassageStepsWithin(const CylinderStepParams& params, const FirstPassageLimits& limits,
+                            double x, double y, double distance);
+
+// Number of standard normals firstPassageJump uses
+const int FIRST_PASSAGE_NORMALS = 5;
+
+// End point of a jump of steps DT steps from (x, y, z), from FIRST_PASSAGE_NORMALS standard normals.
+// Returns the StepOutcome of the end point, which is STEP_INSIDE unless the walk broke the bound.
+uint8_t firstPassageJump(const CylinderStepParams& params, double x, double y, double z, int steps,
+                         const double* normals, double& newX, double& newY, double& newZ);
+
+#endif /* firstPassage_hpp */
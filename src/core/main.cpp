@@ -10,81 +10,64 @@
 #include <iostream>
 #include <src/core/singleExecution.hpp>
 #include <src/core/network/networkExecution.hpp>
+#include <src/core/network/bulkExecution.hpp>
+#include <src/core/network/adjointExecution.hpp>
 #include <vector>
 #include <algorithm>
 #include <src/config/config.h>
 #include <src/config/unused/oldconfig.h>
+#include <src/config/commandLine.hpp>
 #include <time.h>
 #include <filesystem>
 #include <string>
 
-int main() {
-    if (MODE == 0) { // single simulation
+int main(int argc, char** argv) {
+    CommandLineOptions options;
+    try {
+        options = parseCommandLine(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.showHelp) {
+        printUsage(argv[0]);
+        return 0;
+    }
+    
+    // mode, graphics and bulk mode come from config.h and the command line only, networks can change the rest
+    SimulationParameters parameters;
+    options.overrides.applyTo(parameters);
+    
+    if (parameters.mode == 0) { // single simulation
         clock_t tStart = clock();
-        if (GRAPHICS_ON) {
-            singleRunWithGraphics();
+        if (parameters.graphicsOn) {
+            singleRunWithGraphics(parameters);
         } else {
-            singleRunWithoutGraphics();
+            singleRunWithoutGraphics(parameters);
         }
         printf("Time taken: %.2fs\n", (double)(clock() - tStart)/CLOCKS_PER_SEC);
         return 0;
     }
-    if (MODE == 1 && !BULKMODE) { // simulation network
+    if (parameters.mode == 1 && options.adjoint && !parameters.bulkMode) { // receiver responses for emitter localization
         clock_t tStart = clock();
-        if (GRAPHICS_ON) {
-            networkRunWithGraphics("config/network_config.yaml");
-        } else {
-            networkRunWithoutGraphics("config/network_config.yaml");
-        }
+        int result = networkAdjointRun(options.networkConfigPath, options.adjointOutputDir, options.overrides, options.networkThreadCount);
         printf("Time taken: %.2fs\n", (double)(clock() - tStart)/CLOCKS_PER_SEC);
-        return 0;
+        return result;
     }
-    if (MODE == 1 && BULKMODE) { // simulation network bulk run for mlp training data generation
+    if (parameters.mode == 1 && !parameters.bulkMode) { // simulation network
         clock_t tStart = clock();
-        std::string bulkConfigDir = "config/bulkconfigs/";
-        std::vector<std::string> configFiles;
-        
-        // Check if directory exists
-        if (!std::filesystem::exists(bulkConfigDir)) {
-            std::cerr << "Error: Directory " << bulkConfigDir << " does not exist." << std::endl;
-            return 1;
-        }
-        
-        // Collect all YAML files in the directory
-        for (const auto& entry : std::filesystem::directory_iterator(bulkConfigDir)) {
-            if (entry.is_regular_file()) {
-                std::string filename = entry.path().filename().string();
-                if (filename.find("network_config_") != std::string::npos) {
-                    // Check file extension
-                    std::string extension = entry.path().extension().string();
-                    if (extension == ".yaml" || extension == ".yml") {
-                        configFiles.push_back(entry.path().string());
-                    }
-                }
-            }
-        }
-        
-        // Sort files to process them in order
-        std::sort(configFiles.begin(), configFiles.end());
-        
-        if (configFiles.empty()) {
-            std::cout << "No configuration files found in " << bulkConfigDir << std::endl;
-            return 0;
-        }
-        
-        // Process each configuration file
-        std::cout << "Found " << configFiles.size() << " configuration files to process." << std::endl;
-        for (size_t i = 0; i < configFiles.size(); ++i) {
-            std::cout << "Processing [" << (i+1) << "/" << configFiles.size() << "]: " 
-                      << configFiles[i] << std::endl;
-            
-            // Run simulation with this config
-            std::cout << configFiles[i] << std::endl;
-            networkRunWithoutGraphics(configFiles[i]);
+        if (parameters.graphicsOn) {
+            networkRunWithGraphics(options.networkConfigPath, options.overrides, options.networkThreadCount);
+        } else {
+            networkRunWithoutGraphics(options.networkConfigPath, options.overrides, options.networkThreadCount);
         }
-        
-        printf("Total time taken for bulk processing: %.2fs\n", 
-               (double)(clock() - tStart)/CLOCKS_PER_SEC);
+        printf("Time taken: %.2fs\n", (double)(clock() - tStart)/CLOCKS_PER_SEC);
         return 0;
     }
+    if (parameters.mode == 1 && parameters.bulkMode) { // simulation network bulk run for mlp training data generation
+        return networkBulkRun(options.bulkConfigDir, options.bulkOutputDir, options.bulkConcurrency, options.bulkBaseSeed, options.overrides,
+                              options.bulkImpulseResponse, options.resampleCounts);
+    }
+    return 0;
 }
@@ -0,0 +1,46 @@
+//
+//  adjointExecution.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "adjointExecution.hpp"
+#include <src/core/network/adjointResponse.hpp>
+#include <src/core/network/simulationNetworkLoader.hpp>
+#include <src/math/randomStream.hpp>
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+
+int networkAdjointRun(const std::string& networkConfigPath, const std::string& outputDir,
+                      const SimulationParameterOverrides& overrides, int threadCount)
+{
+    NetworkDescription description = SimulationNetworkLoader::loadDescription(networkConfigPath);
+    SimulationParameters parameters;
+    description.simulation.applyTo(parameters);
+    overrides.applyTo(parameters);
+    
+    uint64_t seed;
+    if (description.seed) {
+        seed = *description.seed;
+    } else {
+        seed = generateRandomSeed();
+        std::cout << "No seed in " << networkConfigPath << ", using seed: " << seed << std::endl;
+    }
+    
+    std::string configDir = outputDir + "/" + std::filesystem::path(networkConfigPath).stem().string();
+    for (int p = 0; p < (int)description.pipes.size(); ++p) {
+        const PipeDescription& pipe = description.pipes[p];
+        for (int k = 0; k < (int)pipe.receivers.size(); ++k) {
+            std::string receiverName = pipe.receivers[k].name.empty() ? "receiver" + std::to_string(k) : pipe.receivers[k].name;
+            auto start = std::chrono::steady_clock::now();
+            AdjointResponse response = computeAdjointResponse(description, p, k, parameters, seed, threadCount);
+            writeAdjointResponse(response, description, configDir + "/" + pipe.name + "_" + receiverName);
+            printf("%s %s: adjoint done in %.2fs\n", pipe.name.c_str(), receiverName.c_str(),
+                   std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
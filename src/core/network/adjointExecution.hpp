@@ -0,0 +1,22 @@
+//
+//  adjointExecution.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef adjointExecution_hpp
+#define adjointExecution_hpp
+
+#include <stdio.h>
+#include <string>
+#include <src/config/config.h>
+#include <src/config/simulationParameters.hpp>
+
+// Runs the adjoint of every receiver of a network config instead of the network itself (see adjointResponse.hpp)
+// and writes each receiver's response into outputDir/<config name>/<pipe>_<receiver>/, a file per reached pipe.
+// One run per receiver gives its response to a particle released anywhere in the network.
+int networkAdjointRun(const std::string& networkConfigPath, const std::string& outputDir,
+                      const SimulationParameterOverrides& overrides = SimulationParameterOverrides(), int threadCount = NETWORK_THREAD_COUNT);
+
+#endif /* adjointExecution_hpp */
@@ -0,0 +1,426 @@
+//
+//  adjointResponse.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#define _USE_MATH_DEFINES
+#include "adjointResponse.hpp"
+#include <src/core/network/simulationNetwork.hpp>
+#include <src/core/network/simulationNetworkLoader.hpp>
+#include <src/math/random.hpp>
+#include <src/math/randomStream.hpp>
+#include <src/core/network/threadPool.hpp>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Release points tried per walker before a receiver is taken to have no volume in its pipe
+const int MAX_TRIES_PER_WALKER = 1000;
+// Step standard deviations past the fastest flow beyond which a particle is taken not to reach a pipe end
+const double END_REACH_SIGMAS = 8.0;
+// Walkers per transfer task, each task draws from its own seek of its hub side's stream
+const int TRANSFER_BLOCK_SIZE = 1024;
+
+// A pipe end joined to a hub. Forward particles cross it into the hub at flowOut (the centreline velocity
+// leaving through it, negative when the flow comes in) and the hub sends a share of everything it receives back through it.
+struct HubSide {
+    int pipe;
+    Direction direction;
+    double radius;
+    double halfLength;
+    double flowOut;
+    double share; // of the particles the hub receives
+};
+
+// The sides of one hub, with how far from them a walker can be transferred
+struct AdjointHub {
+    std::vector<HubSide> sides;
+    double section = 0.0; // sum of the sides' r^2, a transfer picks a side in proportion to its own
+    double reach = 0.0; // deepest a particle starting a step can be and still leave through a side
+};
+
+// A block of the walkers of one hub side's pipe, the unit of work of a transfer pass
+struct TransferTask {
+    int hub;
+    int side;
+    int firstWalker;
+    int endWalker;
+    uint64_t block; // index of the block within the side, for its stream position
+};
+
+// The starting points a task drew, in the order it drew them
+struct TransferBatch {
+    std::vector<int> pipe;
+    std::vector<double> x, y, z;
+};
+
+double depthFromEnd(double z, Direction direction, double halfLength)
+{
+    return direction == Direction::LEFT ? z + halfLength : halfLength - z;
+}
+
+// Draws the transfers of walkers [first, end) of the pipe on side's side of hub into batch
+void drawTransfers(const AdjointHub& hub, const HubSide& side, const ParticleStore& walkers, int first, int end,
+                   const std::vector<std::unique_ptr<Simulation>>& simulations, double dt, double sigma,
+                   RandomStream& random, TransferBatch& batch)
+{
+    double attempts = side.share * hub.section / (side.radius * side.radius);
+    for (int j = first; j < end; ++j) {
+        double depth = depthFromEnd(walkers.z()[j], side.direction, side.halfLength);
+        if (depth >= hub.reach) {
+            continue;
+        }
+        int copies = int(attempts);
+        copies += random.nextUniform() < attempts - copies ? 1 : 0;
+        for (int copy = 0; copy < copies; ++copy) {
+            double pick = random.nextUniform() * hub.section;
+            int s = 0;
+            while (s + 1 < (int)hub.sides.size() && pick >= hub.sides[s].radius * hub.sides[s].radius) {
+                pick -= hub.sides[s].radius * hub.sides[s].radius;
+                s++;
+            }
+            const HubSide& from = hub.sides[s];
+            std::pair<double, double> point = generatePointInCircle(random, from.radius);
+            double rSquared = point.first * point.first + point.second * point.second;
+            double step = from.flowOut * (1.0 - rSquared / (from.radius * from.radius)) * dt + random.nextNormal(0.0, sigma);
+            double fromDepth = step - depth;
+            if (fromDepth <= 0.0 || fromDepth >= 2.0 * from.halfLength) {
+                continue;
+            }
+            double fromZ = from.direction == Direction::LEFT ? -from.halfLength + fromDepth : from.halfLength - fromDepth;
+            // A forward particle there would have been taken by an absorbing receiver already
+            bool absorbed = false;
+            for (const auto& absorbing : simulations[from.pipe]->getReceivers()) {
+                absorbed = absorbed || absorbing->hit(glm::dvec3(point.first, point.second, fromZ));
+            }
+            if (!absorbed) {
+                batch.pipe.push_back(from.pipe);
+                batch.x.push_back(point.first);
+                batch.y.push_back(point.second);
+                batch.z.push_back(fromZ);
+            }
+        }
+    }
+}
+
+} // end anonymous namespace
+
+AdjointResponse computeAdjointResponse(const NetworkDescription& description, int pipe, int receiver,
+                                       const SimulationParameters& parameters, uint64_t seed, int threadCount)
+{
+    const PipeDescription& targetPipe = description.pipes.at(pipe);
+    if (receiver < 0 || receiver >= (int)targetPipe.receivers.size()) {
+        throw std::runtime_error(targetPipe.name + ": no receiver " + std::to_string(receiver));
+    }
+
+    // One iteration per frame, so stepping the network an iteration at a time numbers the iterations in order
+    SimulationParameterOverrides overrides;
+    overrides.timeToRun = parameters.timeToRun;
+    overrides.dt = parameters.dt;
+    overrides.diffusionCoefficient = parameters.diffusionCoefficient;
+    overrides.iterationsPerFrame = 1;
+    overrides.firstPassageJumps = parameters.firstPassageJumps;
+    overrides.firstPassageSafety = parameters.firstPassageSafety;
+    overrides.firstPassageMaxSteps = parameters.firstPassageMaxSteps;
+    double sigma = std::sqrt(2.0 * parameters.diffusionCoefficient * parameters.dt);
+
+    // The hubs as the forward run routes them, read off the forward network
+    NetworkDescription forward = description;
+    for (PipeDescription& forwardPipe : forward.pipes) {
+        forwardPipe.emitters.clear();
+        forwardPipe.receivers.clear();
+    }
+    auto forwardNetwork = SimulationNetworkLoader::buildNetwork(forward, "forward of " + targetPipe.name, std::nullopt, overrides);
+    std::vector<AdjointHub> hubs(description.hubs.size());
+    for (int h = 0; h < (int)description.hubs.size(); ++h) {
+        AdjointHub& hub = hubs[h];
+        double fastest = 0.0;
+        for (int b = 0; b < (int)description.hubs[h].branches.size(); ++b) {
+            const HubBranch& branch = description.hubs[h].branches[b];
+            const PipeDescription& branchPipe = description.pipes[branch.pipe];
+            HubSide side;
+            side.pipe = branch.pipe;
+            side.direction = branch.direction;
+            side.radius = branchPipe.radius;
+            side.halfLength = branchPipe.length;
+            side.flowOut = branch.direction == Direction::RIGHT ? branchPipe.flow : -branchPipe.flow;
+            side.share = forwardNetwork->getHubs()[h]->branchProbability(b);
+            hub.sides.push_back(side);
+            hub.section += side.radius * side.radius;
+            fastest = std::max(fastest, side.flowOut);
+        }
+        hub.reach = fastest * parameters.dt + END_REACH_SIGMAS * sigma;
+    }
+
+    // The reversed network: flows negated, no emitters, and of the receivers only the ones that take walkers out
+    // (absorbing ones). Its hubs are sinks, walkers cross them through transfers instead. An observing target only
+    // tells where the walkers start, from a copy of its pipe, so the walkers are not tested against it every step.
+    NetworkDescription reversed = description;
+    reversed.seed = seed;
+    reversed.hubs.clear();
+    int hubSink = (int)reversed.sinks.size();
+    reversed.sinks.push_back("adjoint hub");
+    int targetIndex = -1;
+    for (int p = 0; p < (int)reversed.pipes.size(); ++p) {
+        PipeDescription& reversedPipe = reversed.pipes[p];
+        reversedPipe.flow = -reversedPipe.flow;
+        reversedPipe.emitters.clear();
+        for (ConnectionReference* end : { &reversedPipe.left, &reversedPipe.right }) {
+            if (end->kind == ConnectionKind::HUB) {
+                *end = { ConnectionKind::SINK, hubSink };
+            }
+        }
+        std::vector<ReceiverDescription> kept;
+        for (int k = 0; k < (int)reversedPipe.receivers.size(); ++k) {
+            const ReceiverDescription& candidate = reversedPipe.receivers[k];
+            if (candidate.countingType == 0) {
+                if (p == pipe && k == receiver) {
+                    targetIndex = (int)kept.size();
+                }
+                kept.push_back(candidate);
+            }
+        }
+        reversedPipe.receivers = std::move(kept);
+    }
+    auto network = SimulationNetworkLoader::buildNetwork(reversed, "adjoint of " + targetPipe.name, std::nullopt, overrides);
+    network->setThreadCount(threadCount);
+    const auto& simulations = network->getSimulations();
+    Simulation& source = *simulations[pipe];
+
+    std::unique_ptr<SimulationNetwork> probe;
+    const Receiver* targetReceiver = nullptr;
+    if (targetIndex >= 0) {
+        targetReceiver = source.getReceivers()[targetIndex].get();
+    } else {
+        NetworkDescription single;
+        single.seed = seed;
+        PipeDescription probePipe = targetPipe;
+        probePipe.left = probePipe.right = ConnectionReference();
+        probePipe.emitters.clear();
+        probePipe.receivers = { targetPipe.receivers[receiver] };
+        single.pipes.push_back(probePipe);
+        probe = SimulationNetworkLoader::buildNetwork(single, "adjoint probe", std::nullopt, overrides);
+        targetReceiver = probe->getSimulations()[0]->getReceivers()[0].get();
+    }
+    const Receiver& target = *targetReceiver;
+
+    // Walkers uniformly inside the receiver: points of the pipe section its axial extent covers, kept when they hit it.
+    // The share kept also gives the receiver's volume.
+    double radius = source.getBoundaryRadius();
+    double halfLength = source.getBoundaryHeight();
+    double zMin, zMax;
+    target.getAxialExtent(zMin, zMax);
+    zMin = std::max(zMin, -halfLength);
+    zMax = std::min(zMax, halfLength);
+    RandomStream random(seed, streamIdFromName(targetPipe.name + ":adjoint" + std::to_string(receiver)));
+    std::vector<double> x, y, z;
+    x.reserve(ADJOINT_WALKERS);
+    y.reserve(ADJOINT_WALKERS);
+    z.reserve(ADJOINT_WALKERS);
+    long long tries = 0;
+    while (zMax > zMin && (int)x.size() < ADJOINT_WALKERS && tries < (long long)MAX_TRIES_PER_WALKER * ADJOINT_WALKERS) {
+        std::pair<double, double> point = generatePointInCircle(random, radius);
+        double pointZ = zMin + (zMax - zMin) * random.nextUniform();
+        tries++;
+        if (target.hit(glm::dvec3(point.first, point.second, pointZ))) {
+            x.push_back(point.first);
+            y.push_back(point.second);
+            z.push_back(pointZ);
+        }
+    }
+    if ((int)x.size() < ADJOINT_WALKERS) {
+        throw std::runtime_error(targetPipe.name + ": receiver " + std::to_string(receiver)
+                                 + " has no volume inside its pipe to release adjoint walkers from");
+    }
+    double volume = M_PI * radius * radius * (zMax - zMin) * ADJOINT_WALKERS / double(tries);
+    source.addParticles(x.data(), y.data(), z.data(), ADJOINT_WALKERS);
+
+    AdjointResponse response;
+    response.pipe = pipe;
+    response.receiver = receiver;
+    int iterationCount = parameters.getIterationCount();
+    response.binCount = (iterationCount + response.binIterations - 1) / response.binIterations;
+    response.binSeconds = parameters.dt * response.binIterations;
+    response.tallies.resize(simulations.size());
+    int cellCount = response.radialCells * response.axialCells;
+
+    // Walker counts of the bin in progress, by pipe and cell. When the bin is over its non-zero cells become tallies,
+    // scaled to expected hits per particle released in the cell: receiver volume / (walkers * cell volume)
+    std::vector<std::vector<double>> binCounts(simulations.size());
+    std::vector<char> pipeInBin(simulations.size(), 0);
+    auto closeBin = [&](int bin) {
+        for (int s = 0; s < (int)simulations.size(); ++s) {
+            if (!pipeInBin[s]) {
+                continue;
+            }
+            pipeInBin[s] = 0;
+            double pipeRadius = simulations[s]->getBoundaryRadius();
+            double sliceLength = 2.0 * simulations[s]->getBoundaryHeight() / response.axialCells;
+            std::vector<double>& counts = binCounts[s];
+            for (int cell = 0; cell < cellCount; ++cell) {
+                if (counts[cell] == 0.0) {
+                    continue;
+                }
+                int radialCell = cell / response.axialCells;
+                double inner = pipeRadius * radialCell / response.radialCells;
+                double outer = pipeRadius * (radialCell + 1) / response.radialCells;
+                double cellVolume = M_PI * (outer * outer - inner * inner) * sliceLength;
+                response.tallies[s].push_back({ cell, bin, counts[cell] * volume / (double(ADJOINT_WALKERS) * cellVolume) });
+                counts[cell] = 0.0;
+            }
+        }
+    };
+
+    // Transfers through the hubs. A forward particle at x crossing a hub lands at y in side j with density
+    // share_j / section_j * phi(depth of y + depth of x - flowOut(x) * dt), phi the step noise's; summed over x that
+    // is what a walker at y must turn into. So it tries share_j * (sum of sections) / section_j transfers on average,
+    // each a side picked by section, a uniform point of it and a step, kept at that point if the step reaches y.
+    // The walkers of each side are split into blocks drawn in parallel, each from its side's stream seeked to the
+    // iteration and the block, and the batches are added in task order: the result does not depend on the threads.
+    std::vector<std::vector<RandomStream>> sideRandom(hubs.size());
+    for (int h = 0; h < (int)hubs.size(); ++h) {
+        for (int b = 0; b < (int)hubs[h].sides.size(); ++b) {
+            sideRandom[h].emplace_back(seed, streamIdFromName(targetPipe.name + ":adjointTransfers" + std::to_string(receiver)
+                                                              + ":" + std::to_string(h) + ":" + std::to_string(b)));
+        }
+    }
+    ThreadPool transferPool(threadCount); // idle while the network steps, and the network's pool while this one runs
+    std::vector<TransferTask> tasks;
+    std::vector<TransferBatch> batches;
+    std::vector<std::vector<double>> transferX(simulations.size()), transferY(simulations.size()), transferZ(simulations.size());
+
+    // After iteration i the walkers have taken i + 1 steps: where they are is where a particle released now
+    // would be counted i iterations after its release
+    int alive = ADJOINT_WALKERS;
+    int bin = 0;
+    for (int i = 0; i < iterationCount && alive > 0; ++i) {
+        // Drawn from where the walkers are before the step, added to them after it
+        tasks.clear();
+        for (int h = 0; h < (int)hubs.size(); ++h) {
+            for (int b = 0; b < (int)hubs[h].sides.size(); ++b) {
+                const HubSide& side = hubs[h].sides[b];
+                if (!(side.share > 0.0)) {
+                    continue;
+                }
+                int walkerCount = simulations[side.pipe]->getParticles().size();
+                for (int first = 0; first < walkerCount; first += TRANSFER_BLOCK_SIZE) {
+                    tasks.push_back({ h, b, first, std::min(first + TRANSFER_BLOCK_SIZE, walkerCount),
+                                      uint64_t(first / TRANSFER_BLOCK_SIZE) });
+                }
+            }
+        }
+        if (batches.size() < tasks.size()) {
+            batches.resize(tasks.size());
+        }
+        transferPool.parallelFor((int)tasks.size(), [&](int t) {
+            const TransferTask& task = tasks[t];
+            const AdjointHub& hub = hubs[task.hub];
+            const HubSide& side = hub.sides[task.side];
+            TransferBatch& batch = batches[t];
+            batch.pipe.clear();
+            batch.x.clear();
+            batch.y.clear();
+            batch.z.clear();
+            RandomStream random = sideRandom[task.hub][task.side];
+            random.seek((static_cast<uint64_t>(i) << 24) | task.block);
+            drawTransfers(hub, side, simulations[side.pipe]->getParticles(), task.firstWalker, task.endWalker,
+                          simulations, parameters.dt, sigma, random, batch);
+        });
+        for (int t = 0; t < (int)tasks.size(); ++t) {
+            const TransferBatch& batch = batches[t];
+            for (size_t k = 0; k < batch.pipe.size(); ++k) {
+                transferX[batch.pipe[k]].push_back(batch.x[k]);
+                transferY[batch.pipe[k]].push_back(batch.y[k]);
+                transferZ[batch.pipe[k]].push_back(batch.z[k]);
+            }
+        }
+
+        network->iterateNetwork(1, i);
+        for (int s = 0; s < (int)simulations.size(); ++s) {
+            if (!transferX[s].empty()) {
+                simulations[s]->addParticles(transferX[s].data(), transferY[s].data(), transferZ[s].data(), (int)transferX[s].size());
+                transferX[s].clear();
+                transferY[s].clear();
+                transferZ[s].clear();
+            }
+        }
+
+        if (i / response.binIterations != bin) {
+            closeBin(bin);
+            bin = i / response.binIterations;
+        }
+        alive = 0;
+        for (int s = 0; s < (int)simulations.size(); ++s) {
+            const ParticleStore& walkers = simulations[s]->getParticles();
+            int count = walkers.size();
+            if (count == 0) {
+                continue;
+            }
+            alive += count;
+            std::vector<double>& counts = binCounts[s];
+            if (counts.empty()) {
+                counts.assign(cellCount, 0.0);
+            }
+            pipeInBin[s] = 1;
+            double pipeRadius = simulations[s]->getBoundaryRadius();
+            double pipeHalfLength = simulations[s]->getBoundaryHeight();
+            const double* walkerX = walkers.x();
+            const double* walkerY = walkers.y();
+            const double* walkerZ = walkers.z();
+            for (int j = 0; j < count; ++j) {
+                double r = std::sqrt(walkerX[j] * walkerX[j] + walkerY[j] * walkerY[j]);
+                int radialCell = std::min(int(r / pipeRadius * response.radialCells), response.radialCells - 1);
+                int axialCell = std::clamp(int((walkerZ[j] + pipeHalfLength) / (2.0 * pipeHalfLength) * response.axialCells),
+                                           0, response.axialCells - 1);
+                counts[radialCell * response.axialCells + axialCell] += 1.0;
+            }
+        }
+    }
+    closeBin(bin);
+    return response;
+}
+
+void writeAdjointResponse(const AdjointResponse& response, const NetworkDescription& description, const std::string& directory)
+{
+    std::filesystem::create_directories(directory);
+    std::vector<double> bins(response.binCount);
+    for (int p = 0; p < (int)response.tallies.size(); ++p) {
+        if (response.tallies[p].empty()) {
+            continue;
+        }
+        const PipeDescription& pipe = description.pipes[p];
+        std::string path = directory + "/" + pipe.name + ".txt";
+        std::ofstream outFile(path);
+        if (!outFile) {
+            std::cerr << "Error: Could not open file " << path << " for writing." << std::endl;
+            continue;
+        }
+
+        // The tallies are in bin order, the file goes cell by cell
+        std::vector<AdjointTally> tallies = response.tallies[p];
+        std::stable_sort(tallies.begin(), tallies.end(),
+                         [](const AdjointTally& a, const AdjointTally& b) { return a.cell < b.cell; });
+
+        outFile << pipe.name << " " << pipe.length << " " << pipe.radius << " " << response.radialCells << " "
+                << response.axialCells << " " << response.binSeconds << " " << response.binCount << "\n";
+        outFile << std::setprecision(9);
+        size_t next = 0;
+        for (int cell = 0; cell < response.radialCells * response.axialCells; ++cell) {
+            std::fill(bins.begin(), bins.end(), 0.0);
+            for (; next < tallies.size() && tallies[next].cell == cell; ++next) {
+                bins[tallies[next].bin] = tallies[next].value;
+            }
+            for (int bin = 0; bin < response.binCount; ++bin) {
+                outFile << bins[bin] << (bin != response.binCount - 1 ? ',' : '\n');
+            }
+        }
+    }
+}
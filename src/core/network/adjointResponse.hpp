@@ -0,0 +1,61 @@
+//
+//  adjointResponse.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef adjointResponse_hpp
+#define adjointResponse_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <src/config/config.h>
+#include <src/config/simulationParameters.hpp>
+#include <src/core/network/networkDescription.hpp>
+
+// One receiver's response to emitters anywhere in the network, from a single reverse-time run.
+// A particle released at x is counted at delay d with the probability that a walker released uniformly inside
+// the receiver, moving under the reversed flow, is at x after d + 1 steps, times the receiver's volume: inside a pipe
+// the reversed walk is the adjoint of the forward one, since the flow is divergence free and the walls reflect.
+// Absorbing receivers and sinks remove walkers as they remove particles (a walker back in an absorbing target receiver
+// is a forward particle that would have hit it earlier). Hubs are not their own adjoint, forward particles leave a pipe
+// in proportion to the local flow but enter the next one at uniformly drawn points, so walkers do not go through them:
+// every step a walker near a hub side is replaced, beyond the hub, by the starting points of the forward steps that
+// would have brought a particle to it, drawn with the hubs' forward routing.
+// With first-passage jumps on, a walker in the middle of a jump is tallied where it lands.
+
+// One non-zero tally: expected receiver hits per particle released uniformly in a cell, for one delay bin
+struct AdjointTally {
+    int cell; // radialCell * axialCells + axialCell
+    int bin;
+    double value;
+};
+
+struct AdjointResponse {
+    int pipe = 0; // the receiver, indices into the description
+    int receiver = 0;
+    int radialCells = ADJOINT_RADIAL_CELLS; // every pipe is cut into rings of equal width
+    int axialCells = ADJOINT_AXIAL_CELLS; // and slices of equal length
+    int binIterations = ADJOINT_BIN_ITERATIONS;
+    int binCount = 0;
+    double binSeconds = 0.0;
+    // Per pipe, the non-zero tallies in bin order; empty for pipes no walker reached.
+    // Kept sparse: the walkers only cover part of the grid in any bin, and a dense grid would hold
+    // radialCells * axialCells * binCount doubles for every pipe.
+    std::vector<std::vector<AdjointTally>> tallies;
+};
+
+// Runs the walkers of one receiver of description's network, ADJOINT_WALKERS of them, for the run's iteration count
+// or until none is left. Throws std::runtime_error if the receiver has no volume inside its pipe to release them from.
+AdjointResponse computeAdjointResponse(const NetworkDescription& description, int pipe, int receiver,
+                                       const SimulationParameters& parameters, uint64_t seed, int threadCount = NETWORK_THREAD_COUNT);
+
+// Writes one file per reached pipe into directory: a header line (pipe, half length, radius, radial and axial cells,
+// seconds per bin, bin count), then a line of comma separated bins for every cell, ring by ring from the axis
+// and slice by slice from the left end
+void writeAdjointResponse(const AdjointResponse& response, const NetworkDescription& description, const std::string& directory);
+
+#endif /* adjointResponse_hpp */
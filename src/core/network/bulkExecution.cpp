@@ -0,0 +1,160 @@
+//
+//  bulkExecution.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "bulkExecution.hpp"
+#include <src/core/network/simulationNetwork.hpp>
+#include <src/core/network/simulationNetworkLoader.hpp>
+#include <src/core/network/impulseResponse.hpp>
+#include <src/core/network/threadPool.hpp>
+#include <src/math/randomStream.hpp>
+#include <src/config/config.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <exception>
+
+namespace {
+
+std::vector<std::string> findBulkConfigs(const std::string& bulkConfigDir)
+{
+    std::vector<std::string> configFiles;
+    
+    // Collect all YAML files in the directory
+    for (const auto& entry : std::filesystem::directory_iterator(bulkConfigDir)) {
+        if (entry.is_regular_file()) {
+            std::string filename = entry.path().filename().string();
+            if (filename.find("network_config_") != std::string::npos) {
+                // Check file extension
+                std::string extension = entry.path().extension().string();
+                if (extension == ".yaml" || extension == ".yml") {
+                    configFiles.push_back(entry.path().string());
+                }
+            }
+        }
+    }
+    
+    // Sort files to process them in order
+    std::sort(configFiles.begin(), configFiles.end());
+    return configFiles;
+}
+
+// Same steps as networkRunWithoutGraphics, minus the console output that would interleave between jobs
+// threadBudget is the number of networks run at once: the threads a shared impulse-response measurement may use
+void runBulkJob(const std::string& configPath, const std::string& jobDir, uint64_t defaultSeed,
+                const SimulationParameterOverrides& overrides, bool impulseResponse, bool resampleCounts,
+                int threadBudget)
+{
+    // Bulk configs are usually generated for this one batch: use a compiled network if there is one, but do not
+    // leave a .msnc behind for every config
+    NetworkDescription description = SimulationNetworkLoader::loadDescription(configPath, false);
+    auto network = SimulationNetworkLoader::buildNetwork(description, configPath, defaultSeed, overrides);
+    
+    if (impulseResponse) {
+        // The other jobs wait for the measurement of their network rather than compete with it, so it may use
+        // the whole budget, shared with whatever other measurements run at the same time
+        auto responses = measureImpulseResponses(description, network->getParameters(), threadBudget);
+        synthesizeReceiverCounts(*network, *responses, resampleCounts);
+        network->simulationsWrite(jobDir);
+        return;
+    }
+    
+    // The jobs already keep every core busy, threads inside a network would only compete with them
+    network->setThreadCount(1);
+    network->iterateNetwork(1, 0);
+    network->iterateNetwork(network->getParameters().getIterationCount() - 1, 1);
+    network->simulationsWrite(jobDir);
+}
+
+} // end anonymous namespace
+
+int networkBulkRun(const std::string& bulkConfigDir, const std::string& outputDir, int concurrency, uint64_t baseSeed,
+                   const SimulationParameterOverrides& overrides, bool impulseResponse, bool resampleCounts)
+{
+    namespace fs = std::filesystem;
+    
+    // Check if directory exists
+    if (!fs::exists(bulkConfigDir)) {
+        std::cerr << "Error: Directory " << bulkConfigDir << " does not exist." << std::endl;
+        return 1;
+    }
+    
+    std::vector<std::string> configFiles = findBulkConfigs(bulkConfigDir);
+    if (configFiles.empty()) {
+        std::cout << "No configuration files found in " << bulkConfigDir << std::endl;
+        return 0;
+    }
+    
+    // Resume: a finished config has its output directory, an unfinished one at most a .partial directory
+    std::vector<std::string> pending;
+    for (const std::string& configPath : configFiles) {
+        if (!fs::exists(fs::path(outputDir) / fs::path(configPath).stem())) {
+            pending.push_back(configPath);
+        }
+    }
+    
+    std::cout << "Found " << configFiles.size() << " configuration files, "
+              << configFiles.size() - pending.size() << " already done, " << pending.size() << " to process." << std::endl;
+    if (pending.empty()) {
+        return 0;
+    }
+    
+    fs::create_directories(outputDir);
+    
+    ThreadPool pool(concurrency);
+    std::cout << "Running " << std::min<size_t>(pool.getThreadCount(), pending.size()) << " networks at a time." << std::endl;
+    if (impulseResponse) {
+        std::cout << "Outputs come from impulse responses, " << (resampleCounts ? "with Poisson counts." : "as expected counts.") << std::endl;
+    }
+    
+    std::mutex outputMutex;
+    std::atomic<int> finishedCount(0);
+    std::atomic<int> failedCount(0);
+    auto bulkStart = std::chrono::steady_clock::now();
+    
+    pool.parallelFor((int)pending.size(), [&](int i) {
+        const std::string& configPath = pending[i];
+        std::string configName = fs::path(configPath).stem().string();
+        fs::path finalDir = fs::path(outputDir) / configName;
+        fs::path partialDir = fs::path(outputDir) / (configName + ".partial");
+        uint64_t defaultSeed = baseSeed ^ streamIdFromName(configName);
+        
+        auto jobStart = std::chrono::steady_clock::now();
+        std::string error;
+        try {
+            fs::remove_all(partialDir); // left over from an interrupted run
+            runBulkJob(configPath, partialDir.string(), defaultSeed, overrides, impulseResponse, resampleCounts,
+                       pool.getThreadCount());
+            fs::rename(partialDir, finalDir);
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        auto jobEnd = std::chrono::steady_clock::now();
+        double jobSeconds = std::chrono::duration<double>(jobEnd - jobStart).count();
+        double totalSeconds = std::chrono::duration<double>(jobEnd - bulkStart).count();
+        
+        int finished = ++finishedCount;
+        std::lock_guard<std::mutex> lock(outputMutex);
+        if (error.empty()) {
+            double remaining = totalSeconds / finished * (pending.size() - finished);
+            printf("[%d/%zu] %s done in %.2fs (elapsed %.0fs, about %.0fs left)\n",
+                   finished, pending.size(), configName.c_str(), jobSeconds, totalSeconds, remaining);
+        } else {
+            failedCount++;
+            std::cerr << "[" << finished << "/" << pending.size() << "] " << configName
+                      << " failed after " << jobSeconds << "s: " << error << std::endl;
+        }
+        fflush(stdout);
+    });
+    
+    printf("Total time taken for bulk processing: %.2fs, %d failed\n",
+           std::chrono::duration<double>(std::chrono::steady_clock::now() - bulkStart).count(), failedCount.load());
+    return failedCount == 0 ? 0 : 1;
+}
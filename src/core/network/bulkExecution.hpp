@@ -0,0 +1,31 @@
+//
+//  bulkExecution.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef bulkExecution_hpp
+#define bulkExecution_hpp
+
+#include <stdio.h>
+#include <string>
+#include <cstdint>
+#include <src/config/config.h>
+#include <src/config/simulationParameters.hpp>
+
+// Runs every network_config_*.yaml of bulkConfigDir without graphics, several networks at the same time.
+// Each config writes to outputDir/<config name>/, and configs whose directory already exists are skipped,
+// so an interrupted bulk run can be restarted where it stopped. A run writes into <config name>.partial
+// first and only renames it when it is complete.
+// concurrency <= 0 means one network per hardware thread. Configs without their own seed get one
+// derived from baseSeed and the config file name, so a bulk run is reproducible as a whole.
+// Every config keeps its own simulation: section, overrides are applied on top of each.
+// With impulseResponse set the configs are not run: their outputs are synthesized from the impulse responses of
+// their network (see src/core/network/impulseResponse.hpp), measured once for all the configs that share it,
+// with Poisson counts when resampleCounts is set and the expected counts otherwise.
+int networkBulkRun(const std::string& bulkConfigDir, const std::string& outputDir, int concurrency, uint64_t baseSeed,
+                   const SimulationParameterOverrides& overrides = SimulationParameterOverrides(),
+                   bool impulseResponse = BULK_IMPULSE_RESPONSE, bool resampleCounts = IMPULSE_RESPONSE_RESAMPLE);
+
+#endif /* bulkExecution_hpp */
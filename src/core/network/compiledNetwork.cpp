@@ -0,0 +1,346 @@
+//
+//  compiledNetwork.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "compiledNetwork.hpp"
+#include <src/output/binaryWriter.hpp>
+#include <src/output/binaryReader.hpp>
+#include <src/output/mappedFile.hpp>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <cstring>
+
+namespace {
+
+const char COMPILED_NETWORK_MAGIC[4] = { 'M', 'S', 'N', 'C' };
+
+// Ints that may be negative go in as their 32-bit pattern
+void writeInt(BinaryWriter& writer, int value) {
+    writer.writeUInt32(static_cast<uint32_t>(value));
+}
+
+int readInt(BinaryReader& reader) {
+    return static_cast<int>(reader.readUInt32());
+}
+
+void writeVector(BinaryWriter& writer, const glm::dvec3& value) {
+    writer.writeDouble(value.x);
+    writer.writeDouble(value.y);
+    writer.writeDouble(value.z);
+}
+
+glm::dvec3 readVector(BinaryReader& reader) {
+    double x = reader.readDouble();
+    double y = reader.readDouble();
+    double z = reader.readDouble();
+    return glm::dvec3(x, y, z);
+}
+
+template <class T, class WriteValue>
+void writeOptional(BinaryWriter& writer, const std::optional<T>& value, WriteValue writeValue) {
+    writer.writeUInt8(value ? 1 : 0);
+    if (value) {
+        writeValue(*value);
+    }
+}
+
+void writeConnection(BinaryWriter& writer, const ConnectionReference& connection) {
+    writer.writeUInt8(static_cast<uint8_t>(connection.kind));
+    writer.writeVarint(connection.kind == ConnectionKind::NONE ? 0 : connection.index);
+}
+
+// Counts are checked against what is left of the file before anything is allocated for them
+uint64_t readCount(BinaryReader& reader, size_t fileSize) {
+    uint64_t count = reader.readVarint();
+    if (count > fileSize) {
+        throw std::runtime_error("Count out of range in compiled network");
+    }
+    return count;
+}
+
+void checkIndex(uint64_t index, size_t size) {
+    if (index >= size) {
+        throw std::runtime_error("Index out of range in compiled network");
+    }
+}
+
+ConnectionReference readConnection(BinaryReader& reader, const NetworkDescription& description) {
+    ConnectionReference connection;
+    uint8_t kind = reader.readUInt8();
+    uint64_t index = reader.readVarint();
+    if (kind == static_cast<uint8_t>(ConnectionKind::HUB)) {
+        checkIndex(index, description.hubs.size());
+    } else if (kind == static_cast<uint8_t>(ConnectionKind::SINK)) {
+        checkIndex(index, description.sinks.size());
+    } else if (kind != static_cast<uint8_t>(ConnectionKind::NONE)) {
+        throw std::runtime_error("Unknown connection kind in compiled network");
+    }
+    connection.kind = static_cast<ConnectionKind>(kind);
+    connection.index = (connection.kind == ConnectionKind::NONE) ? -1 : static_cast<int>(index);
+    return connection;
+}
+
+NetworkDescription readDescription(BinaryReader& reader, size_t fileSize) {
+    NetworkDescription description;
+    
+    if (reader.readUInt8()) {
+        description.seed = reader.readUInt64();
+    }
+    SimulationParameterOverrides& simulation = description.simulation;
+    if (reader.readUInt8()) simulation.timeToRun = reader.readDouble();
+    if (reader.readUInt8()) simulation.dt = reader.readDouble();
+    if (reader.readUInt8()) simulation.diffusionCoefficient = reader.readDouble();
+    if (reader.readUInt8()) simulation.iterationsPerFrame = readInt(reader);
+    if (reader.readUInt8()) simulation.firstPassageJumps = reader.readUInt8() != 0;
+    if (reader.readUInt8()) simulation.firstPassageSafety = reader.readDouble();
+    if (reader.readUInt8()) simulation.firstPassageMaxSteps = readInt(reader);
+    description.flowValue = reader.readDouble();
+    
+    uint64_t sinkCount = readCount(reader, fileSize);
+    for (uint64_t i = 0; i < sinkCount; ++i) {
+        description.sinks.push_back(reader.readString());
+    }
+    
+    // Hubs point at pipes that come later in the file, their indices are checked once the pipe count is known
+    uint64_t hubCount = readCount(reader, fileSize);
+    description.hubs.resize(hubCount);
+    for (HubDescription& hub : description.hubs) {
+        uint8_t routing = reader.readUInt8();
+        if (routing > static_cast<uint8_t>(HubRouting::FLUX)) {
+            throw std::runtime_error("Unknown hub routing in compiled network");
+        }
+        hub.routing = static_cast<HubRouting>(routing);
+        hub.streamId = reader.readUInt64();
+        uint64_t branchCount = readCount(reader, fileSize);
+        for (uint64_t b = 0; b < branchCount; ++b) {
+            HubBranch branch;
+            branch.pipe = static_cast<int>(reader.readVarint());
+            branch.direction = reader.readUInt8() ? Direction::RIGHT : Direction::LEFT;
+            branch.weight = reader.readDouble();
+            hub.branches.push_back(branch);
+        }
+    }
+    
+    uint64_t pipeCount = readCount(reader, fileSize);
+    description.pipes.resize(pipeCount);
+    for (PipeDescription& pipe : description.pipes) {
+        pipe.name = reader.readString();
+        pipe.parentName = reader.readString();
+        pipe.length = reader.readDouble();
+        pipe.radius = reader.readDouble();
+        pipe.particleCount = readInt(reader);
+        pipe.flow = reader.readDouble();
+        pipe.left = readConnection(reader, description);
+        pipe.right = readConnection(reader, description);
+        
+        uint64_t receiverCount = readCount(reader, fileSize);
+        pipe.receivers.resize(receiverCount);
+        for (ReceiverDescription& receiver : pipe.receivers) {
+            uint8_t kind = reader.readUInt8();
+            if (kind > static_cast<uint8_t>(ReceiverKind::TRAP)) {
+                throw std::runtime_error("Unknown receiver kind in compiled network");
+            }
+            receiver.kind = static_cast<ReceiverKind>(kind);
+            receiver.name = reader.readString();
+            receiver.position = readVector(reader);
+            receiver.countingType = readInt(reader);
+            receiver.orientation = readInt(reader);
+            receiver.radius = reader.readDouble();
+            receiver.thickness = reader.readDouble();
+            receiver.length = reader.readDouble();
+            receiver.theta = reader.readDouble();
+            receiver.deltaTheta = reader.readDouble();
+        }
+        
+        uint64_t emitterCount = readCount(reader, fileSize);
+        pipe.emitters.resize(emitterCount);
+        for (EmitterDescription& emitter : pipe.emitters) {
+            uint8_t kind = reader.readUInt8();
+            if (kind > static_cast<uint8_t>(EmissionKind::PULSE_TRAIN)) {
+                throw std::runtime_error("Unknown emitter kind in compiled network");
+            }
+            emitter.kind = static_cast<EmissionKind>(kind);
+            emitter.position = readVector(reader);
+            uint64_t patternLength = readCount(reader, fileSize);
+            emitter.pattern.reserve(patternLength);
+            for (uint64_t k = 0; k < patternLength; ++k) {
+                emitter.pattern.push_back(readInt(reader));
+            }
+            emitter.patternType = reader.readString();
+            emitter.rate = reader.readDouble();
+            emitter.count = readInt(reader);
+            emitter.start = reader.readDouble();
+            emitter.stop = reader.readDouble();
+            emitter.period = reader.readDouble();
+            emitter.pulses = readInt(reader);
+        }
+    }
+    
+    for (const HubDescription& hub : description.hubs) {
+        for (const HubBranch& branch : hub.branches) {
+            checkIndex(branch.pipe, description.pipes.size());
+        }
+    }
+    if (!reader.atEnd()) {
+        throw std::runtime_error("Trailing bytes in compiled network");
+    }
+    return description;
+}
+
+} // end anonymous namespace
+
+std::string compiledNetworkPath(const std::string& configPath)
+{
+    return configPath + ".msnc";
+}
+
+ConfigFingerprint fingerprintConfigFile(const std::string& configPath)
+{
+    MappedFile file(configPath);
+    if (!file.isOpen()) {
+        throw std::runtime_error("Could not open network config " + configPath);
+    }
+    
+    // FNV-1a
+    ConfigFingerprint fingerprint;
+    fingerprint.size = file.getSize();
+    fingerprint.hash = 0xCBF29CE484222325ULL;
+    const uint8_t* data = file.getData();
+    for (size_t i = 0; i < file.getSize(); ++i) {
+        fingerprint.hash ^= data[i];
+        fingerprint.hash *= 0x100000001B3ULL;
+    }
+    return fingerprint;
+}
+
+bool writeCompiledNetwork(const std::string& path, const ConfigFingerprint& source, const NetworkDescription& description)
+{
+    std::string temporaryPath = path + ".tmp";
+    bool written;
+    {
+        BinaryWriter writer(temporaryPath);
+        if (!writer.isOpen()) {
+            return false;
+        }
+        
+        writer.writeBytes(COMPILED_NETWORK_MAGIC, sizeof(COMPILED_NETWORK_MAGIC));
+        writer.writeUInt16(COMPILED_NETWORK_VERSION);
+        writer.writeUInt64(source.size);
+        writer.writeUInt64(source.hash);
+        
+        writeOptional(writer, description.seed, [&](uint64_t value) { writer.writeUInt64(value); });
+        const SimulationParameterOverrides& simulation = description.simulation;
+        writeOptional(writer, simulation.timeToRun, [&](double value) { writer.writeDouble(value); });
+        writeOptional(writer, simulation.dt, [&](double value) { writer.writeDouble(value); });
+        writeOptional(writer, simulation.diffusionCoefficient, [&](double value) { writer.writeDouble(value); });
+        writeOptional(writer, simulation.iterationsPerFrame, [&](int value) { writeInt(writer, value); });
+        writeOptional(writer, simulation.firstPassageJumps, [&](bool value) { writer.writeUInt8(value ? 1 : 0); });
+        writeOptional(writer, simulation.firstPassageSafety, [&](double value) { writer.writeDouble(value); });
+        writeOptional(writer, simulation.firstPassageMaxSteps, [&](int value) { writeInt(writer, value); });
+        writer.writeDouble(description.flowValue);
+        
+        writer.writeVarint(description.sinks.size());
+        for (const std::string& sink : description.sinks) {
+            writer.writeString(sink);
+        }
+        
+        writer.writeVarint(description.hubs.size());
+        for (const HubDescription& hub : description.hubs) {
+            writer.writeUInt8(static_cast<uint8_t>(hub.routing));
+            writer.writeUInt64(hub.streamId);
+            writer.writeVarint(hub.branches.size());
+            for (const HubBranch& branch : hub.branches) {
+                writer.writeVarint(branch.pipe);
+                writer.writeUInt8(branch.direction == Direction::RIGHT ? 1 : 0);
+                writer.writeDouble(branch.weight);
+            }
+        }
+        
+        writer.writeVarint(description.pipes.size());
+        for (const PipeDescription& pipe : description.pipes) {
+            writer.writeString(pipe.name);
+            writer.writeString(pipe.parentName);
+            writer.writeDouble(pipe.length);
+            writer.writeDouble(pipe.radius);
+            writeInt(writer, pipe.particleCount);
+            writer.writeDouble(pipe.flow);
+            writeConnection(writer, pipe.left);
+            writeConnection(writer, pipe.right);
+            
+            writer.writeVarint(pipe.receivers.size());
+            for (const ReceiverDescription& receiver : pipe.receivers) {
+                writer.writeUInt8(static_cast<uint8_t>(receiver.kind));
+                writer.writeString(receiver.name);
+                writeVector(writer, receiver.position);
+                writeInt(writer, receiver.countingType);
+                writeInt(writer, receiver.orientation);
+                writer.writeDouble(receiver.radius);
+                writer.writeDouble(receiver.thickness);
+                writer.writeDouble(receiver.length);
+                writer.writeDouble(receiver.theta);
+                writer.writeDouble(receiver.deltaTheta);
+            }
+            
+            writer.writeVarint(pipe.emitters.size());
+            for (const EmitterDescription& emitter : pipe.emitters) {
+                writer.writeUInt8(static_cast<uint8_t>(emitter.kind));
+                writeVector(writer, emitter.position);
+                writer.writeVarint(emitter.pattern.size());
+                for (int count : emitter.pattern) {
+                    writeInt(writer, count);
+                }
+                writer.writeString(emitter.patternType);
+                writer.writeDouble(emitter.rate);
+                writeInt(writer, emitter.count);
+                writer.writeDouble(emitter.start);
+                writer.writeDouble(emitter.stop);
+                writer.writeDouble(emitter.period);
+                writeInt(writer, emitter.pulses);
+            }
+        }
+        
+        writer.flush();
+        written = writer.isGood();
+    }
+    
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(temporaryPath, path, error);
+    }
+    if (!written || error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+std::optional<NetworkDescription> readCompiledNetwork(const std::string& path, const ConfigFingerprint& source)
+{
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        return std::nullopt;
+    }
+    
+    try {
+        BinaryReader reader(file.getData(), file.getSize(), "compiled network " + path);
+        if (file.getSize() < sizeof(COMPILED_NETWORK_MAGIC)
+            || std::memcmp(file.getData(), COMPILED_NETWORK_MAGIC, sizeof(COMPILED_NETWORK_MAGIC)) != 0) {
+            throw std::runtime_error(path + " is not a compiled network");
+        }
+        reader.readFixed(sizeof(COMPILED_NETWORK_MAGIC));
+        if (reader.readUInt16() != COMPILED_NETWORK_VERSION) {
+            return std::nullopt; // written by another version, recompiled from the YAML
+        }
+        if (reader.readUInt64() != source.size || reader.readUInt64() != source.hash) {
+            return std::nullopt; // the config changed since
+        }
+        return readDescription(reader, file.getSize());
+    } catch (const std::exception& e) {
+        std::cerr << "[Warning] Ignoring damaged compiled network: " << e.what() << "\n";
+        return std::nullopt;
+    }
+}
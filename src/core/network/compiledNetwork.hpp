@@ -0,0 +1,51 @@
+//
+//  compiledNetwork.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef compiledNetwork_hpp
+#define compiledNetwork_hpp
+
+#include <stdio.h>
+#include <string>
+#include <optional>
+#include <cstdint>
+#include "networkDescription.hpp"
+
+// Compiled network cache: a NetworkDescription written to a flat binary file next to its config
+// (<config>.msnc), so later runs of the same config skip parsing the YAML, resolving connections,
+// finding hubs and solving flows. The file is memory-mapped when it is read.
+//
+// Layout, little-endian like the receiver outputs (src/output/receiverOutput.hpp):
+//   char[4]  magic              "MSNC"
+//   uint16   format version     COMPILED_NETWORK_VERSION
+//   uint64   config size        bytes of the YAML it was compiled from
+//   uint64   config hash        FNV-1a of those bytes
+//   then the description: seed, simulation: section, flow, sinks, hubs, pipes with their receivers and emitters
+//   (see writeCompiledNetwork), strings and counts as varints
+//
+// The cache is stale, and the YAML is read again, when the config's bytes or the format version differ.
+// Bump the version whenever the description or what the loader puts in it changes.
+const uint16_t COMPILED_NETWORK_VERSION = 4;
+
+// Identity of a config file's contents, what a compiled network is checked against
+struct ConfigFingerprint {
+    uint64_t size = 0;
+    uint64_t hash = 0;
+};
+
+std::string compiledNetworkPath(const std::string& configPath);
+
+// Throws std::runtime_error if the file cannot be read
+ConfigFingerprint fingerprintConfigFile(const std::string& configPath);
+
+// Writes through a temporary file that is renamed into place, so a reader never sees half a cache.
+// Returns false (and leaves no file) if it could not be written.
+bool writeCompiledNetwork(const std::string& path, const ConfigFingerprint& source, const NetworkDescription& description);
+
+// The description in the cache at path, or nullopt if there is none, it is stale for source or it is damaged
+std::optional<NetworkDescription> readCompiledNetwork(const std::string& path, const ConfigFingerprint& source);
+
+#endif /* compiledNetwork_hpp */
@@ -0,0 +1,333 @@
+//
+//  flowSolver.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#define _USE_MATH_DEFINES
+#include "flowSolver.hpp"
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <numeric>
+#include <stdexcept>
+#include <iostream>
+
+namespace {
+
+// Solutions kept before the cache is emptied, a bulk batch rarely has more distinct networks than this
+const size_t FLOW_CACHE_CAPACITY = 64;
+const double CG_TOLERANCE = 1e-12; // relative residual
+
+struct CacheEntry {
+    FlowNetwork network; // compared on lookup, so a hash collision can never give a wrong solution
+    FlowSolution solution;
+};
+
+std::mutex cacheMutex;
+std::unordered_map<uint64_t, CacheEntry> cache;
+
+// FNV-1a over raw bytes
+void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+}
+
+template <class T>
+void hashVector(uint64_t& hash, const std::vector<T>& values) {
+    uint64_t size = values.size();
+    hashBytes(hash, &size, sizeof(size));
+    if (!values.empty()) {
+        hashBytes(hash, values.data(), values.size() * sizeof(T));
+    }
+}
+
+bool sameDoubles(const std::vector<double>& a, const std::vector<double>& b) {
+    // Bitwise, so NaN (a free pressure) equals NaN
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0);
+}
+
+bool sameNetwork(const FlowNetwork& a, const FlowNetwork& b) {
+    return a.nodeCount == b.nodeCount && a.viscosity == b.viscosity
+        && a.pipeLeftNode == b.pipeLeftNode && a.pipeRightNode == b.pipeRightNode
+        && sameDoubles(a.pipeRadius, b.pipeRadius) && sameDoubles(a.pipeLength, b.pipeLength)
+        && sameDoubles(a.nodePressure, b.nodePressure) && sameDoubles(a.nodeInflow, b.nodeInflow);
+}
+
+int findRoot(std::vector<int>& parent, int node) {
+    while (parent[node] != node) {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+    }
+    return node;
+}
+
+// Jacobi preconditioned conjugate gradient for the symmetric positive definite CSR matrix (rowStart, columns, values)
+void conjugateGradient(const std::vector<int>& rowStart, const std::vector<int>& columns, const std::vector<double>& values,
+                       const std::vector<double>& rhs, std::vector<double>& x)
+{
+    int n = static_cast<int>(rhs.size());
+    std::vector<double> inverseDiagonal(n), r(rhs), z(n), p(n), q(n);
+    for (int i = 0; i < n; ++i) {
+        for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+            if (columns[k] == i) {
+                inverseDiagonal[i] = 1.0 / values[k];
+            }
+        }
+    }
+
+    double rhsNorm = std::sqrt(std::inner_product(rhs.begin(), rhs.end(), rhs.begin(), 0.0));
+    x.assign(n, 0.0);
+    if (rhsNorm == 0.0) {
+        return;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        z[i] = inverseDiagonal[i] * r[i];
+    }
+    p = z;
+    double rz = std::inner_product(r.begin(), r.end(), z.begin(), 0.0);
+
+    int maxIterations = std::max(1000, 10 * n);
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+        for (int i = 0; i < n; ++i) {
+            double sum = 0.0;
+            for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+                sum += values[k] * p[columns[k]];
+            }
+            q[i] = sum;
+        }
+        double alpha = rz / std::inner_product(p.begin(), p.end(), q.begin(), 0.0);
+        double residualSquared = 0.0;
+        for (int i = 0; i < n; ++i) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+            residualSquared += r[i] * r[i];
+        }
+        if (std::sqrt(residualSquared) <= CG_TOLERANCE * rhsNorm) {
+            return;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            z[i] = inverseDiagonal[i] * r[i];
+        }
+        double rzNext = std::inner_product(r.begin(), r.end(), z.begin(), 0.0);
+        double beta = rzNext / rz;
+        rz = rzNext;
+        for (int i = 0; i < n; ++i) {
+            p[i] = z[i] + beta * p[i];
+        }
+    }
+    std::cerr << "[Warning] Flow solver did not converge in " << maxIterations << " iterations.\n";
+}
+
+FlowSolution solveUncached(const FlowNetwork& network)
+{
+    int nodeCount = network.nodeCount;
+    int pipeCount = static_cast<int>(network.pipeRadius.size());
+
+    std::vector<double> conductance(pipeCount);
+    for (int e = 0; e < pipeCount; ++e) {
+        double radius = network.pipeRadius[e];
+        double length = network.pipeLength[e];
+        if (radius <= 0 || length <= 0) {
+            throw std::runtime_error("Flow solver: every pipe needs a positive radius and length");
+        }
+        conductance[e] = M_PI * radius * radius * radius * radius / (8.0 * network.viscosity * length);
+    }
+
+    std::vector<double> pressure(network.nodePressure);
+    std::vector<double> inflow(network.nodeInflow);
+    auto isFixed = [&](int node) { return !std::isnan(pressure[node]); };
+
+    // A connected part of the network without a pressure only works out if nothing flows in:
+    // then its pressure is pinned to 0 (it has no flow at all), otherwise the flow has nowhere to go
+    std::vector<int> parent(nodeCount);
+    std::iota(parent.begin(), parent.end(), 0);
+    for (int e = 0; e < pipeCount; ++e) {
+        parent[findRoot(parent, network.pipeLeftNode[e])] = findRoot(parent, network.pipeRightNode[e]);
+    }
+    std::vector<char> componentFixed(nodeCount, 0);
+    std::vector<char> componentHasInflow(nodeCount, 0);
+    for (int node = 0; node < nodeCount; ++node) {
+        int root = findRoot(parent, node);
+        componentFixed[root] |= isFixed(node);
+        componentHasInflow[root] |= (!isFixed(node) && inflow[node] != 0.0);
+    }
+    for (int node = 0; node < nodeCount; ++node) {
+        int root = findRoot(parent, node);
+        if (!componentFixed[root]) {
+            if (componentHasInflow[root]) {
+                throw std::runtime_error("Flow solver: part of the network has an inflow but no pressure boundary");
+            }
+            pressure[node] = 0.0;
+            componentFixed[root] = 1;
+        }
+    }
+
+    // Incident pipes of every node (CSR)
+    std::vector<int> incidentStart(nodeCount + 1, 0);
+    for (int e = 0; e < pipeCount; ++e) {
+        if (network.pipeLeftNode[e] == network.pipeRightNode[e]) continue; // a loop onto one node carries nothing
+        incidentStart[network.pipeLeftNode[e] + 1]++;
+        incidentStart[network.pipeRightNode[e] + 1]++;
+    }
+    for (int node = 0; node < nodeCount; ++node) {
+        incidentStart[node + 1] += incidentStart[node];
+    }
+    std::vector<int> incident(incidentStart[nodeCount]);
+    {
+        std::vector<int> fill(incidentStart.begin(), incidentStart.end() - 1);
+        for (int e = 0; e < pipeCount; ++e) {
+            if (network.pipeLeftNode[e] == network.pipeRightNode[e]) continue;
+            incident[fill[network.pipeLeftNode[e]]++] = e;
+            incident[fill[network.pipeRightNode[e]]++] = e;
+        }
+    }
+    auto otherEnd = [&](int e, int node) {
+        return network.pipeLeftNode[e] == node ? network.pipeRightNode[e] : network.pipeLeftNode[e];
+    };
+
+    // Prune free leaves: a free node on a single pipe sends its whole inflow through that pipe,
+    // so it can be folded into its neighbour and its pressure recovered afterwards.
+    // On a tree this solves everything exactly in linear time, the solver below only sees the cycles.
+    std::vector<int> degree(nodeCount);
+    for (int node = 0; node < nodeCount; ++node) {
+        degree[node] = incidentStart[node + 1] - incidentStart[node];
+    }
+    std::vector<char> pipeRemoved(pipeCount, 0);
+    std::vector<char> eliminated(nodeCount, 0);
+    std::vector<std::pair<int, int>> eliminations; // (node, pipe), in elimination order
+    std::vector<int> leaves;
+    for (int node = 0; node < nodeCount; ++node) {
+        if (!isFixed(node) && degree[node] == 1) {
+            leaves.push_back(node);
+        }
+    }
+    while (!leaves.empty()) {
+        int node = leaves.back();
+        leaves.pop_back();
+        int pipe = -1;
+        for (int k = incidentStart[node]; k < incidentStart[node + 1]; ++k) {
+            if (!pipeRemoved[incident[k]]) {
+                pipe = incident[k];
+                break;
+            }
+        }
+        int neighbour = otherEnd(pipe, node);
+        pipeRemoved[pipe] = 1;
+        eliminated[node] = 1;
+        eliminations.push_back({node, pipe});
+        inflow[neighbour] += inflow[node];
+        if (!isFixed(neighbour) && --degree[neighbour] == 1) {
+            leaves.push_back(neighbour);
+        }
+    }
+
+    // The rest: G p = inflow over the free nodes left, pipes to fixed nodes moved to the right hand side
+    std::vector<int> unknownOf(nodeCount, -1);
+    std::vector<int> unknownNode;
+    for (int node = 0; node < nodeCount; ++node) {
+        if (!isFixed(node) && !eliminated[node]) {
+            unknownOf[node] = static_cast<int>(unknownNode.size());
+            unknownNode.push_back(node);
+        }
+    }
+    int unknownCount = static_cast<int>(unknownNode.size());
+    if (unknownCount > 0) {
+        std::vector<int> rowStart(unknownCount + 1, 0);
+        std::vector<int> columns;
+        std::vector<double> values;
+        std::vector<double> rhs(unknownCount);
+        for (int i = 0; i < unknownCount; ++i) {
+            int node = unknownNode[i];
+            double diagonal = 0.0;
+            rhs[i] = inflow[node];
+            for (int k = incidentStart[node]; k < incidentStart[node + 1]; ++k) {
+                int pipe = incident[k];
+                if (pipeRemoved[pipe]) continue;
+                int neighbour = otherEnd(pipe, node);
+                diagonal += conductance[pipe];
+                if (isFixed(neighbour)) {
+                    rhs[i] += conductance[pipe] * pressure[neighbour];
+                } else {
+                    columns.push_back(unknownOf[neighbour]);
+                    values.push_back(-conductance[pipe]);
+                }
+            }
+            columns.push_back(i);
+            values.push_back(diagonal);
+            rowStart[i + 1] = static_cast<int>(columns.size());
+        }
+
+        std::vector<double> solved;
+        conjugateGradient(rowStart, columns, values, rhs, solved);
+        for (int i = 0; i < unknownCount; ++i) {
+            pressure[unknownNode[i]] = solved[i];
+        }
+    }
+
+    // Back substitute the pruned leaves, last pruned first: the pressure drop to the neighbour carries the leaf's inflow
+    for (auto it = eliminations.rbegin(); it != eliminations.rend(); ++it) {
+        int node = it->first;
+        int pipe = it->second;
+        pressure[node] = pressure[otherEnd(pipe, node)] + inflow[node] / conductance[pipe];
+    }
+
+    FlowSolution solution;
+    solution.nodePressure = pressure;
+    solution.pipeFlow.resize(pipeCount);
+    for (int e = 0; e < pipeCount; ++e) {
+        solution.pipeFlow[e] = conductance[e] * (pressure[network.pipeLeftNode[e]] - pressure[network.pipeRightNode[e]]);
+    }
+    return solution;
+}
+
+} // end anonymous namespace
+
+uint64_t FlowNetwork::topologyHash() const
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    hashBytes(hash, &nodeCount, sizeof(nodeCount));
+    hashBytes(hash, &viscosity, sizeof(viscosity));
+    hashVector(hash, pipeLeftNode);
+    hashVector(hash, pipeRightNode);
+    hashVector(hash, pipeRadius);
+    hashVector(hash, pipeLength);
+    hashVector(hash, nodePressure);
+    hashVector(hash, nodeInflow);
+    return hash;
+}
+
+FlowSolution FlowSolver::solve(const FlowNetwork& network)
+{
+    uint64_t key = network.topologyHash();
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(key);
+        if (it != cache.end() && sameNetwork(it->second.network, network)) {
+            return it->second.solution;
+        }
+    }
+
+    // Solved outside the lock, two threads on the same new network just both solve it
+    FlowSolution solution = solveUncached(network);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (cache.size() >= FLOW_CACHE_CAPACITY) {
+        cache.clear();
+    }
+    cache[key] = { network, solution };
+    return solution;
+}
+
+double FlowSolver::centrelineVelocity(double volumeFlow, double radius)
+{
+    // Poiseuille: the mean velocity is Q / (pi r^2) and the centreline velocity twice that
+    return 2.0 * volumeFlow / (M_PI * radius * radius);
+}
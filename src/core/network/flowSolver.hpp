@@ -0,0 +1,69 @@
+//
+//  flowSolver.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef flowSolver_hpp
+#define flowSolver_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+// Hydraulic resistance model of a pipe network.
+// Nodes are the places pipes meet (hubs) and the sinks; every pipe joins the node at its left end to the node
+// at its right end. A node either has a fixed pressure or a given volume inflow (0 for a plain junction).
+struct FlowNetwork {
+    int nodeCount = 0;
+    std::vector<int> pipeLeftNode;
+    std::vector<int> pipeRightNode;
+    std::vector<double> pipeRadius; // m
+    std::vector<double> pipeLength; // m, full length
+    std::vector<double> nodePressure; // Pa, NaN for a node whose pressure is solved for
+    std::vector<double> nodeInflow; // m^3/s into the network at the node, only used where the pressure is free
+    double viscosity = 3.5e-3; // Pa s (blood)
+
+    int addNode();
+    int addPipe(int leftNode, int rightNode, double radius, double length);
+
+    // Hash of everything the solution depends on, in the order it was added
+    uint64_t topologyHash() const;
+};
+
+struct FlowSolution {
+    std::vector<double> pipeFlow; // m^3/s from the left end to the right end (+z)
+    std::vector<double> nodePressure; // Pa
+};
+
+// Solves a FlowNetwork: Kirchhoff's current law at every free node, with the Poiseuille conductance
+// pi r^4 / (8 mu L) for every pipe. The free pressures come from a Jacobi preconditioned conjugate gradient
+// on the sparse (CSR) weighted graph Laplacian, so the cost grows with the number of pipes, not its square.
+// Solutions are cached in memory by FlowNetwork::topologyHash, so a batch of configs over the same network
+// solves it once. Safe to call from several threads.
+class FlowSolver
+{
+public:
+    static FlowSolution solve(const FlowNetwork& network);
+
+    // Poiseuille centreline velocity of a pipe carrying the given volume flow, what Simulation calls its flow
+    static double centrelineVelocity(double volumeFlow, double radius);
+};
+
+inline int FlowNetwork::addNode() {
+    nodePressure.push_back(std::numeric_limits<double>::quiet_NaN());
+    nodeInflow.push_back(0.0);
+    return nodeCount++;
+}
+
+inline int FlowNetwork::addPipe(int leftNode, int rightNode, double radius, double length) {
+    pipeLeftNode.push_back(leftNode);
+    pipeRightNode.push_back(rightNode);
+    pipeRadius.push_back(radius);
+    pipeLength.push_back(length);
+    return static_cast<int>(pipeRadius.size()) - 1;
+}
+
+#endif /* flowSolver_hpp */
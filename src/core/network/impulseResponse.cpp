@@ -0,0 +1,306 @@
+//
+//  impulseResponse.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "impulseResponse.hpp"
+#include <src/core/network/simulationNetwork.hpp>
+#include <src/core/network/simulationNetworkLoader.hpp>
+#include <src/math/fft.hpp>
+#include <src/math/poisson.hpp>
+#include <src/math/randomStream.hpp>
+#include <src/config/config.h>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <string>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Measured networks kept before the cache is emptied
+const size_t IMPULSE_CACHE_CAPACITY = 16;
+
+std::mutex cacheMutex;
+std::map<std::string, std::shared_future<std::shared_ptr<const ImpulseResponses>>> cache;
+
+// Measurements running right now, they share the caller's thread budget
+std::atomic<int> measurementsRunning(0);
+
+template <class T>
+void appendBytes(std::string& signature, const T& value)
+{
+    signature.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendString(std::string& signature, const std::string& value)
+{
+    appendBytes(signature, value.size());
+    signature += value;
+}
+
+// Everything a measurement depends on: the run parameters and the network without its emitters' schedules.
+// Pipe names are in it too, they seed the pipes' streams, so a bulk run measures the same way every time.
+std::string responseSignature(const NetworkDescription& description, const SimulationParameters& parameters)
+{
+    std::string signature;
+    appendBytes(signature, parameters.dt);
+    appendBytes(signature, parameters.diffusionCoefficient);
+    appendBytes(signature, parameters.getIterationCount());
+    appendBytes(signature, parameters.firstPassageJumps);
+    appendBytes(signature, parameters.firstPassageSafety);
+    appendBytes(signature, parameters.firstPassageMaxSteps);
+    appendBytes(signature, description.sinks.size());
+    for (const HubDescription& hub : description.hubs) {
+        appendBytes(signature, hub.routing);
+        appendBytes(signature, hub.streamId);
+        appendBytes(signature, hub.branches.size());
+        for (const HubBranch& branch : hub.branches) {
+            appendBytes(signature, branch.pipe);
+            appendBytes(signature, branch.direction);
+            appendBytes(signature, branch.weight);
+        }
+    }
+    for (const PipeDescription& pipe : description.pipes) {
+        appendString(signature, pipe.name);
+        appendBytes(signature, pipe.length);
+        appendBytes(signature, pipe.radius);
+        appendBytes(signature, pipe.flow);
+        appendBytes(signature, pipe.left.kind);
+        appendBytes(signature, pipe.left.index);
+        appendBytes(signature, pipe.right.kind);
+        appendBytes(signature, pipe.right.index);
+        appendBytes(signature, pipe.receivers.size());
+        for (const ReceiverDescription& receiver : pipe.receivers) {
+            appendBytes(signature, receiver.kind);
+            appendBytes(signature, receiver.position);
+            appendBytes(signature, receiver.countingType);
+            appendBytes(signature, receiver.orientation);
+            appendBytes(signature, receiver.radius);
+            appendBytes(signature, receiver.thickness);
+            appendBytes(signature, receiver.length);
+            appendBytes(signature, receiver.theta);
+            appendBytes(signature, receiver.deltaTheta);
+        }
+        appendBytes(signature, pipe.emitters.size());
+        for (const EmitterDescription& emitter : pipe.emitters) {
+            appendBytes(signature, emitter.position);
+        }
+    }
+    return signature;
+}
+
+std::shared_ptr<const ImpulseResponses> measure(const NetworkDescription& description, const SimulationParameters& parameters,
+                                                uint64_t seed, int threadCount)
+{
+    SimulationParameterOverrides overrides;
+    overrides.timeToRun = parameters.timeToRun;
+    overrides.dt = parameters.dt;
+    overrides.diffusionCoefficient = parameters.diffusionCoefficient;
+    overrides.iterationsPerFrame = parameters.iterationsPerFrame;
+    overrides.firstPassageJumps = parameters.firstPassageJumps;
+    overrides.firstPassageSafety = parameters.firstPassageSafety;
+    overrides.firstPassageMaxSteps = parameters.firstPassageMaxSteps;
+    int iterationCount = parameters.getIterationCount();
+
+    auto responses = std::make_shared<ImpulseResponses>();
+    for (const PipeDescription& pipe : description.pipes) {
+        responses->emitterCount += (int)pipe.emitters.size();
+        responses->receiverCount += (int)pipe.receivers.size();
+    }
+    responses->response.reserve(size_t(responses->emitterCount) * responses->receiverCount);
+
+    std::vector<uint64_t> bins;
+    std::vector<uint64_t> counts;
+    for (int p = 0; p < (int)description.pipes.size(); ++p) {
+        for (const EmitterDescription& emitter : description.pipes[p].emitters) {
+            // The network with this emitter alone, as a single pulse at the first iteration
+            NetworkDescription single = description;
+            single.seed = seed;
+            for (PipeDescription& pipe : single.pipes) {
+                pipe.emitters.clear();
+            }
+            EmitterDescription pulse;
+            pulse.kind = EmissionKind::PULSE_TRAIN;
+            pulse.position = emitter.position;
+            pulse.count = IMPULSE_RESPONSE_PARTICLES;
+            pulse.pulses = 1;
+            single.pipes[p].emitters.push_back(pulse);
+
+            auto network = SimulationNetworkLoader::buildNetwork(single, "impulse response", std::nullopt, overrides);
+            network->setThreadCount(threadCount);
+            for (const auto& simulation : network->getSimulations()) {
+                for (const auto& receiver : simulation->getReceivers()) {
+                    receiver->setTimeWindow(iterationCount, parameters.dt, 1);
+                }
+            }
+            network->iterateNetwork(iterationCount, 0);
+
+            for (const auto& simulation : network->getSimulations()) {
+                for (const auto& receiver : simulation->getReceivers()) {
+                    receiver->collectNonZeroBins(bins, counts);
+                    std::vector<double> response(bins.empty() ? 0 : bins.back() + 1, 0.0);
+                    for (size_t i = 0; i < bins.size(); ++i) {
+                        response[bins[i]] = double(counts[i]) / IMPULSE_RESPONSE_PARTICLES;
+                    }
+                    responses->response.push_back(std::move(response));
+                }
+            }
+        }
+    }
+    return responses;
+}
+
+// The iteration number a bulk run records step t under: it runs its first iteration as frame 0 and the rest
+// as frame 1 (see runBulkJob), so the steps after the first start at iterationsPerFrame
+int recordedIteration(int step, const SimulationParameters& parameters)
+{
+    return step == 0 ? 0 : parameters.iterationsPerFrame + step - 1;
+}
+
+} // end anonymous namespace
+
+std::shared_ptr<const ImpulseResponses> measureImpulseResponses(const NetworkDescription& description,
+                                                                const SimulationParameters& parameters,
+                                                                int threadBudget)
+{
+    std::string signature = responseSignature(description, parameters);
+    std::promise<std::shared_ptr<const ImpulseResponses>> promise;
+    std::shared_future<std::shared_ptr<const ImpulseResponses>> future;
+    bool measuring = false;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(signature);
+        if (it != cache.end()) {
+            future = it->second;
+        } else {
+            if (cache.size() >= IMPULSE_CACHE_CAPACITY) {
+                cache.clear();
+            }
+            future = promise.get_future().share();
+            cache[signature] = future;
+            measuring = true;
+        }
+    }
+    
+    // Measured outside the lock, the other threads asking for it wait on the future
+    if (measuring) {
+        // The share is fixed when the measurement starts, the streams make the result the same whatever it is
+        int running = ++measurementsRunning;
+        int threadCount = std::max(1, threadBudget / running);
+        try {
+            promise.set_value(measure(description, parameters, streamIdFromName(signature), threadCount));
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+        --measurementsRunning;
+    }
+    return future.get();
+}
+
+void synthesizeReceiverCounts(SimulationNetwork& network, const ImpulseResponses& responses, bool resample)
+{
+    const SimulationParameters& parameters = network.getParameters();
+    int iterationCount = parameters.getIterationCount();
+    const auto& simulations = network.getSimulations();
+    
+    // The emissions of every emitter as (step, count), replayed from a copy of its schedule
+    std::vector<std::vector<std::pair<int, int>>> emissions;
+    int receiverCount = 0;
+    for (const auto& simulation : simulations) {
+        for (const auto& emitter : simulation->getEmitters()) {
+            EmissionSchedule schedule = emitter->getSchedule();
+            emissions.emplace_back();
+            while (schedule.nextStep() < iterationCount) {
+                emissions.back().push_back({ (int)schedule.nextStep(), schedule.nextCount() });
+                schedule.advance();
+            }
+        }
+        receiverCount += (int)simulation->getReceivers().size();
+    }
+    if ((int)emissions.size() != responses.emitterCount || receiverCount != responses.receiverCount) {
+        throw std::runtime_error("Impulse responses were measured on a different network");
+    }
+    
+    size_t longest = 0;
+    for (const std::vector<double>& response : responses.response) {
+        longest = std::max(longest, response.size());
+    }
+    // Large enough that the circular convolution does not wrap into the first iterationCount values
+    size_t size = fftSize(iterationCount + longest);
+    double transformCost = 2.0 * size * std::log2(double(size));
+    std::vector<std::vector<std::complex<double>>> emissionSpectra(emissions.size()); // computed when first needed
+    
+    // Expected counts are multiples of 1 / IMPULSE_RESPONSE_PARTICLES, anything below half of that is FFT round-off
+    const double noiseFloor = 0.5 / IMPULSE_RESPONSE_PARTICLES;
+    
+    std::vector<double> expected(iterationCount);
+    std::vector<std::complex<double>> spectrumSum;
+    int receiverIndex = 0;
+    for (const auto& simulation : simulations) {
+        const auto& receivers = simulation->getReceivers();
+        for (int k = 0; k < (int)receivers.size(); ++k, ++receiverIndex) {
+            std::fill(expected.begin(), expected.end(), 0.0);
+            spectrumSum.clear();
+            for (int e = 0; e < (int)emissions.size(); ++e) {
+                const std::vector<double>& response = responses.response[size_t(e) * responses.receiverCount + receiverIndex];
+                if (response.empty() || emissions[e].empty()) {
+                    continue;
+                }
+                
+                // A pass over the response per emission is cheaper than the transforms while emissions are sparse
+                if (double(emissions[e].size()) * response.size() <= transformCost) {
+                    for (const auto& [step, count] : emissions[e]) {
+                        int end = (int)std::min<size_t>(iterationCount, step + response.size());
+                        for (int t = step; t < end; ++t) {
+                            expected[t] += count * response[t - step];
+                        }
+                    }
+                    continue;
+                }
+                if (emissionSpectra[e].empty()) {
+                    std::vector<double> signal(iterationCount, 0.0);
+                    for (const auto& [step, count] : emissions[e]) {
+                        signal[step] += count;
+                    }
+                    emissionSpectra[e] = realSpectrum(signal, size);
+                }
+                std::vector<std::complex<double>> responseSpectrum = realSpectrum(response, size);
+                if (spectrumSum.empty()) {
+                    spectrumSum.assign(size, 0.0);
+                }
+                for (size_t i = 0; i < size; ++i) {
+                    spectrumSum[i] += emissionSpectra[e][i] * responseSpectrum[i];
+                }
+            }
+            // One inverse transform for the sum over the emitters
+            if (!spectrumSum.empty()) {
+                fft(spectrumSum, true);
+                for (int t = 0; t < iterationCount; ++t) {
+                    expected[t] += spectrumSum[t].real();
+                }
+            }
+            
+            Receiver& receiver = *receivers[k];
+            RandomStream random(network.getSeed(), streamIdFromName(simulation->getName() + ":receiver" + std::to_string(k)));
+            for (int t = 0; t < iterationCount; ++t) {
+                if (expected[t] < noiseFloor) {
+                    continue;
+                }
+                if (resample) {
+                    int count = generatePoisson(random, expected[t]);
+                    if (count > 0) {
+                        receiver.increaseParticlesReceived(recordedIteration(t, parameters), count);
+                    }
+                } else {
+                    receiver.addExpectedParticlesReceived(recordedIteration(t, parameters), expected[t]);
+                }
+            }
+        }
+    }
+}
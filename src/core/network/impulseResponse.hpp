@@ -0,0 +1,46 @@
+//
+//  impulseResponse.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef impulseResponse_hpp
+#define impulseResponse_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <memory>
+#include <src/config/simulationParameters.hpp>
+#include <src/core/network/networkDescription.hpp>
+
+class SimulationNetwork;
+
+// Expected receiver hits per particle an emitter releases, by iterations since the release.
+// Particles never interact, so what a receiver counts is the sum over the emitters of each emitter's emissions
+// convolved with its impulse response, and one measurement per emitter stands for every emission pattern.
+struct ImpulseResponses {
+    int emitterCount = 0; // over all pipes, in pipe order then emitter order
+    int receiverCount = 0; // the same for receivers
+    // response[emitter * receiverCount + receiver][delay], up to the last delay that had a hit
+    std::vector<std::vector<double>> response;
+};
+
+// The impulse responses of description's network under parameters: one run per emitter that releases
+// IMPULSE_RESPONSE_PARTICLES particles at the first iteration with the other emitters removed.
+// Measurements are kept in memory, so networks that only differ in their emitters' schedules are measured once.
+// Safe to call from several threads, a thread asking for a measurement in progress waits for it.
+// threadBudget is the number of threads the measurements may use together (at least 1): each measurement network
+// gets an equal share of it with the measurements already running, so callers that are themselves spread over
+// every core do not oversubscribe the machine.
+std::shared_ptr<const ImpulseResponses> measureImpulseResponses(const NetworkDescription& description,
+                                                                const SimulationParameters& parameters,
+                                                                int threadBudget);
+
+// Fills the receivers of network, built from the same description, with the counts of a whole bulk run of its
+// emitters' schedules without running it: the expected counts come from convolving the emissions with the
+// responses (directly for sparse emissions, by FFT otherwise), then either stay as they are or, with resample set,
+// are replaced by Poisson counts around them, the shot noise a real run would have.
+void synthesizeReceiverCounts(SimulationNetwork& network, const ImpulseResponses& responses, bool resample);
+
+#endif /* impulseResponse_hpp */
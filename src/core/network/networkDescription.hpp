@@ -0,0 +1,104 @@
+//
+//  networkDescription.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef networkDescription_hpp
+#define networkDescription_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <src/config/simulationParameters.hpp>
+#include <src/core/connections/connection.hpp>
+#include <src/core/connections/hub.hpp>
+#include <src/core/emitters/emissionSchedule.hpp>
+
+// A network config with everything resolved: connections are indices instead of names, hubs are found,
+// flows are solved and positions are cartesian. It is what the YAML loader produces and what the compiled
+// network cache stores, and SimulationNetworkLoader builds the actual objects from it the same way for both.
+
+enum class ConnectionKind : uint8_t {
+    NONE,
+    HUB,
+    SINK
+};
+
+struct ConnectionReference {
+    ConnectionKind kind = ConnectionKind::NONE;
+    int index = -1; // into NetworkDescription::hubs or ::sinks
+};
+
+enum class ReceiverKind : uint8_t {
+    SPHERE,
+    RING,
+    RING_WITH_THICKNESS,
+    TRAP
+};
+
+struct ReceiverDescription {
+    ReceiverKind kind = ReceiverKind::SPHERE;
+    std::string name;
+    glm::dvec3 position = glm::dvec3(0.0); // cartesian, in the pipe's frame
+    int countingType = 0;
+    int orientation = 2; // rings
+    double radius = 0.0; // spheres, and the pipe radius for traps
+    double thickness = 0.0; // thick rings and traps
+    double length = 0.0; // traps
+    double theta = 0.0; // traps
+    double deltaTheta = 0.0; // traps
+};
+
+struct EmitterDescription {
+    EmissionKind kind = EmissionKind::PATTERN;
+    glm::dvec3 position = glm::dvec3(0.0);
+    std::vector<int> pattern; // pattern emitters
+    std::string patternType; // "repeat" or "complete"
+    double rate = 0.0; // Poisson emitters, particles per second
+    int count = 0; // pulse trains, particles per pulse
+    double start = 0.0; // seconds, Poisson emitters and pulse trains
+    double stop = 0.0; // seconds, Poisson emitters (0: no end)
+    double period = 0.0; // seconds, pulse trains
+    int pulses = 0; // pulse trains (0: no limit)
+};
+
+struct PipeDescription {
+    std::string name;
+    std::string parentName;
+    double length = 0.0; // half length, as in the config
+    double radius = 0.0;
+    int particleCount = 0;
+    double flow = 0.0; // centreline velocity along z
+    ConnectionReference left;
+    ConnectionReference right;
+    std::vector<ReceiverDescription> receivers;
+    std::vector<EmitterDescription> emitters;
+};
+
+struct HubBranch {
+    int pipe; // index into NetworkDescription::pipes
+    Direction direction;
+    double weight;
+};
+
+struct HubDescription {
+    HubRouting routing = HubRouting::RADIUS_SQUARED;
+    uint64_t streamId = 0; // of the hub's RandomStream, combined with the run seed
+    std::vector<HubBranch> branches;
+};
+
+struct NetworkDescription {
+    std::optional<uint64_t> seed;
+    SimulationParameterOverrides simulation; // what the simulation: section sets
+    double flowValue = 0.0; // the top-level flow:
+    std::vector<PipeDescription> pipes; // in the order the network steps them
+    std::vector<HubDescription> hubs;
+    std::vector<std::string> sinks;
+};
+
+#endif /* networkDescription_hpp */
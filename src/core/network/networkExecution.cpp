@@ -10,15 +10,17 @@
 const unsigned int SCR_WIDTH = 400;
 const unsigned int SCR_HEIGHT = 400;
 
-int networkRunWithoutGraphics(const std::string& networkConfigPath)
+int networkRunWithoutGraphics(const std::string& networkConfigPath, const SimulationParameterOverrides& overrides, int threadCount)
 {
     // Use relative paths for cross-platform compatibility
-    auto network = SimulationNetworkLoader::loadFromYAML(networkConfigPath);
+    auto network = SimulationNetworkLoader::loadFromYAML(networkConfigPath, std::nullopt, overrides);
+    network->setThreadCount(threadCount);
+    const SimulationParameters& parameters = network->getParameters();
     
     // Bu kısımda normalde number of iterations kere itere ettiriyodum ama baştaki particle sayılarını yazabilmek için ikiye ayırdım. Önce bir kere itere ettiriyorum sonra alive particle count alıyorum ondan sonra geri kalanını çalıştırıyorum. Debug için var sonra değiştirebilirim eski haline. Eski hali şuydu: network->iterateNetwork(NUMBER_OF_ITERATIONS,0);
     network->iterateNetwork(1,0);
     std::cout << "Particles in the Beginning: " << network->getAliveParticleCountInNetwork() << std::endl;
-    network->iterateNetwork(NUMBER_OF_ITERATIONS-1,1);
+    network->iterateNetwork(parameters.getIterationCount()-1,1);
     
     
     network->simulationsWrite("Output/Outputs");
@@ -28,7 +30,7 @@ int networkRunWithoutGraphics(const std::string& networkConfigPath)
     return 0;
 }
 
-int networkRunWithGraphics(const std::string& networkConfigPath){
+int networkRunWithGraphics(const std::string& networkConfigPath, const SimulationParameterOverrides& overrides, int threadCount){
     // Initialize GLFW
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -121,13 +123,15 @@ int networkRunWithGraphics(const std::string& networkConfigPath){
     
     
     // Initialize the simulation with relative path
-    auto network = SimulationNetworkLoader::loadFromYAML(networkConfigPath);
+    auto network = SimulationNetworkLoader::loadFromYAML(networkConfigPath, std::nullopt, overrides);
+    network->setThreadCount(threadCount);
+    const SimulationParameters& parameters = network->getParameters();
     Simulation* firstSimulation = network->getFirstSimulation();
 //    Simulation* secondSimulation = network->getSecondSimulation();
 
     
     // Render loop
-    int totalFrames = NUMBER_OF_ITERATIONS / ITERATIONS_PER_FRAME;
+    int totalFrames = parameters.getIterationCount() / parameters.iterationsPerFrame;
     int currentFrame = 0;
     
     // FPS calculation variables
@@ -160,7 +164,7 @@ int networkRunWithGraphics(const std::string& networkConfigPath){
         glClear(GL_COLOR_BUFFER_BIT);
         
         //Iterate the simulation
-        network->iterateNetwork(ITERATIONS_PER_FRAME, currentFrame);
+        network->iterateNetwork(parameters.iterationsPerFrame, currentFrame);
         
         //Draw the receiver
 
@@ -24,7 +24,8 @@
 #include <src/core/network/simulationNetwork.hpp>
 #include <src/core/network/simulationNetworkLoader.hpp>
 
-int networkRunWithoutGraphics(const std::string& networkConfigPath);
-int networkRunWithGraphics(const std::string& networkConfigPath);
+// overrides are applied over the network's simulation parameters, threadCount is the network's thread count
+int networkRunWithoutGraphics(const std::string& networkConfigPath, const SimulationParameterOverrides& overrides = SimulationParameterOverrides(), int threadCount = NETWORK_THREAD_COUNT);
+int networkRunWithGraphics(const std::string& networkConfigPath, const SimulationParameterOverrides& overrides = SimulationParameterOverrides(), int threadCount = NETWORK_THREAD_COUNT);
 
 #endif /* networkExecution_hpp */
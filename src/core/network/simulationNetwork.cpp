@@ -9,30 +9,130 @@
 #include <cstdlib> // For system()
 #include <chrono>
 #include <iomanip>
+#include <ctime>
 #include <sstream>
+#include <algorithm>
+#include <cmath>
 
 SimulationNetwork::SimulationNetwork()
 {}
 
+// Below this many particles in the network an iteration is cheaper to run on one thread than to wake the pool
+const int PARALLEL_PARTICLE_THRESHOLD = 4096;
+// Chunks aimed for per thread: enough for stealing to even out a bad cost estimate, few enough to keep the merge cheap
+const int CHUNKS_PER_THREAD = 8;
+
 void SimulationNetwork::iterateNetwork(int iterationCount, int currentFrame)
 {
-    int localCurrentFrame = 0;
+    if (!threadPool && threadCount != 1) {
+        threadPool = std::make_unique<ThreadPool>(threadCount);
+        scheduler = std::make_unique<WorkStealingScheduler>(*threadPool);
+    }
+    
+    std::function<void(int)> stepChunk = [&](int c) {
+        const WorkChunk& chunk = chunks[c];
+        simulations[chunk.simulationIndex]->stepBlocks(chunk.firstBlock, chunk.endBlock, chunkResults[c]);
+    };
     
     for (int i = 0; i < iterationCount; ++i) {
-        for(int j = 0; j < simulations.size(); ++j) {
-            simulations[j]->iterateSimulation(1, currentFrame, i);
-            if (localCurrentFrame % 1000 == 0) {
-                //std::cout << simulations[j]->getAliveParticleCount() << std::endl;
+        // Emitters run on this thread before any particle moves
+        fireEmitters();
+        std::vector<int> blockCounts(simulations.size());
+        int aliveCount = 0;
+        for (int j = 0; j < simulations.size(); ++j) {
+            blockCounts[j] = simulations[j]->beginStep(currentFrame, i);
+            aliveCount += simulations[j]->getParticles().size();
+        }
+        
+        // Cut every pipe into chunks of about the same number of alive particles. Particle populations are very
+        // skewed (the emitter pipe holds nearly everything early on), so one task per pipe would leave threads idle.
+        bool parallel = scheduler && aliveCount >= PARALLEL_PARTICLE_THRESHOLD;
+        double targetCost = parallel
+            ? std::max<double>(BROWNIAN_BLOCK_SIZE, double(aliveCount) / (threadPool->getThreadCount() * CHUNKS_PER_THREAD))
+            : double(aliveCount) + 1.0;
+        chunks.clear();
+        chunkCosts.clear();
+        firstChunkOfSimulation.assign(simulations.size() + 1, 0);
+        for (int j = 0; j < simulations.size(); ++j) {
+            firstChunkOfSimulation[j] = (int)chunks.size();
+            splitIntoChunks(j, blockCounts[j], targetCost);
+        }
+        firstChunkOfSimulation[simulations.size()] = (int)chunks.size();
+        if (chunkResults.size() < chunks.size()) {
+            chunkResults.resize(chunks.size());
+        }
+        
+        // Step phase: a chunk only writes its own slots and its own result
+        if (parallel) {
+            scheduler->run(chunkCosts, stepChunk);
+        } else {
+            for (int c = 0; c < chunks.size(); ++c) {
+                stepChunk(c);
+            }
+        }
+        
+        // Merge phase, on this thread in a fixed order: chunk results pipe by pipe in block order (kills,
+        // receiver counts), then the hand-offs, then every pipe adds what it received in one batch, so hub choices
+        // and entry positions come out of their streams in the same order every run
+        for (int j = 0; j < simulations.size(); ++j) {
+            int first = firstChunkOfSimulation[j];
+            simulations[j]->finishStep(chunkResults.data() + first, firstChunkOfSimulation[j + 1] - first);
+        }
+        for (int j = 0; j < simulations.size(); ++j) {
+            simulations[j]->flushOutbox();
+        }
+        for (int j = 0; j < simulations.size(); ++j) {
+            simulations[j]->flushInbox();
+        }
+    }
+}
+
+void SimulationNetwork::fireEmitters()
+{
+    if (!emissionQueueBuilt) {
+        for (const auto& simulation : simulations) {
+            for (const auto& emitter : simulation->getEmitters()) {
+                if (emitter->getNextEmission() != EmissionSchedule::NEVER) {
+                    emissionQueue.push({ emitter->getNextEmission(), (int)emitters.size() });
+                }
+                emitters.push_back(emitter.get());
             }
         }
-        if (localCurrentFrame % 1000 == 0) {
-            //std::cout << "--" << std::endl;
+        emissionQueueBuilt = true;
+    }
+    
+    while (!emissionQueue.empty() && emissionQueue.top().first <= emissionStep) {
+        int index = emissionQueue.top().second;
+        emissionQueue.pop();
+        emitters[index]->emitDue(emissionStep);
+        if (emitters[index]->getNextEmission() != EmissionSchedule::NEVER) {
+            emissionQueue.push({ emitters[index]->getNextEmission(), index });
         }
-        localCurrentFrame++;
+    }
+    ++emissionStep;
+}
+
+void SimulationNetwork::splitIntoChunks(int simulationIndex, int blockCount, double targetCost)
+{
+    if (blockCount == 0) {
+        return;
+    }
+    
+    // The particles in the store are the cost estimate, spread evenly over the pipe's blocks. getAliveParticleCount
+    // starts at the configured particle count even for pipes that were built empty, so it can't be used here.
+    double cost = simulations[simulationIndex]->getParticles().size();
+    int chunkCount = std::min(blockCount, std::max(1, (int)std::ceil(cost / targetCost)));
+    for (int c = 0; c < chunkCount; ++c) {
+        int firstBlock = (int)((long long)blockCount * c / chunkCount);
+        int endBlock = (int)((long long)blockCount * (c + 1) / chunkCount);
+        chunks.push_back({ simulationIndex, firstBlock, endBlock });
+        chunkCosts.push_back(cost * (endBlock - firstBlock) / blockCount);
     }
 }
 
 void SimulationNetwork::addSimulation(std::unique_ptr<Simulation> sim) {
+    sim->setDeferHandoffs(true);
+    sim->setEmittersScheduled(true);
     simulations.push_back(std::move(sim));  // moves ownership
 }
 
@@ -55,8 +155,16 @@ void SimulationNetwork::simulationsWrite(const std::string &outputDir) const {
     auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()) % 1000;
     
+    // localtime shares one buffer between threads, and bulk runs write several networks at once
+    std::tm localTime;
+#ifdef _WIN32
+    localtime_s(&localTime, &now_time_t);
+#else
+    localtime_r(&now_time_t, &localTime);
+#endif
+    
     std::stringstream timestamp;
-    timestamp << std::put_time(std::localtime(&now_time_t), "%Y.%m.%d-%H.%M.%S");
+    timestamp << std::put_time(&localTime, "%Y.%m.%d-%H.%M.%S");
     timestamp << "." << std::setfill('0') << std::setw(3) << now_ms.count();
     
     std::string runDir = outputDir + "/" + timestamp.str();
@@ -76,7 +184,7 @@ void SimulationNetwork::simulationsWrite(const std::string &outputDir) const {
     // Write general data of the network (flow velocity, diffusion coefficient)
     std::string output;
     std::ostringstream oss;
-    oss << std::setprecision(17) << D << " " << std::setprecision(17) << flow_value << "\n";
+    oss << std::setprecision(17) << parameters.diffusionCoefficient << " " << std::setprecision(17) << flow_value << "\n";
     output += oss.str();
     
     // Write the output to a file
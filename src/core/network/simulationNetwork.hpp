@@ -10,11 +10,23 @@
 
 #include <stdio.h>
 #include <vector>
+#include <queue>
+#include <cstdint>
 #include <src/core/connections/simulation.hpp>
 #include <src/config/config.h>
+#include <src/config/simulationParameters.hpp>
 #include <src/config/unused/oldconfig.h>
 #include <src/core/connections/hub.hpp>
 #include <src/core/connections/sink.hpp>
+#include <src/core/network/threadPool.hpp>
+#include <src/core/network/workStealingScheduler.hpp>
+
+// A range of particle blocks of one pipe, the unit of work of a parallel iteration
+struct WorkChunk {
+    int simulationIndex;
+    int firstBlock;
+    int endBlock;
+};
 
 class SimulationNetwork
 {
@@ -23,8 +35,31 @@ private:
     std::vector<std::unique_ptr<Hub>> hubs;
     std::vector<std::unique_ptr<Sink>> sinks;
     double flow_value;
+    SimulationParameters parameters;
+    uint64_t seed = 0; // run seed every pipe and hub stream is derived from
+    int threadCount = NETWORK_THREAD_COUNT;
+    std::unique_ptr<ThreadPool> threadPool; // created on the first iteration
+    std::unique_ptr<WorkStealingScheduler> scheduler;
+    // Per-iteration work list, kept between iterations so the buffers are reused
+    std::vector<WorkChunk> chunks;
+    std::vector<double> chunkCosts;
+    std::vector<StepResult> chunkResults;
+    std::vector<int> firstChunkOfSimulation;
+    // Emitter events of every pipe as (step, emitter), earliest first; emitters is filled on the first iteration,
+    // in pipe order, so emitters due at the same step fire in the order the pipes were added
+    std::vector<Emitter*> emitters;
+    std::priority_queue<std::pair<int64_t, int>, std::vector<std::pair<int64_t, int>>, std::greater<>> emissionQueue;
+    int64_t emissionStep = 0; // iterations run so far
+    bool emissionQueueBuilt = false;
+    
+    // Runs the emitters due this iteration: an iteration without one only compares the top of the queue
+    void fireEmitters();
+    void splitIntoChunks(int simulationIndex, int blockCount, double targetCost);
 public:
     SimulationNetwork();
+    // Each iteration steps every pipe (in parallel when there are enough particles, with big pipes split into chunks
+    // of blocks that idle threads can steal), then applies the chunk results and hands the particles that left a pipe
+    // to its neighbours in a fixed order, so results do not depend on the thread count
     void iterateNetwork(int iterationCount, int currentFrame);
     void addSimulation(std::unique_ptr<Simulation> sim);
     void addHub(std::unique_ptr<Hub> hub);
@@ -32,12 +67,22 @@ public:
     
     void simulationsWrite(const std::string& outputDir) const;
     
+    const std::vector<std::unique_ptr<Simulation>>& getSimulations() const { return simulations; }
+    const std::vector<std::unique_ptr<Hub>>& getHubs() const { return hubs; }
     Simulation* getFirstSimulation();
     Simulation* getSecondSimulation();
     
     void setFlowValue(double value) { flow_value = value; }
     double getFlowValue() const { return flow_value; }
     
+    void setParameters(const SimulationParameters& value) { parameters = value; }
+    const SimulationParameters& getParameters() const { return parameters; }
+    
+    void setSeed(uint64_t value) { seed = value; }
+    // <= 0 for one thread per hardware thread, 1 to run serially
+    void setThreadCount(int count) { threadCount = count; scheduler.reset(); threadPool.reset(); }
+    uint64_t getSeed() const { return seed; }
+    
     int getAliveParticleCountInNetwork();
     int getParticlesInSinks();
 };
@@ -9,22 +9,27 @@
 
 #include <yaml-cpp/yaml.h>
 #include <unordered_map>
-#include <queue>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
 #include <stdexcept>
 #include <optional>
+#include <algorithm>
 
 // Your own headers
 #include <src/core/connections/simulation.hpp>
 #include <src/core/connections/hub.hpp>
 #include <src/core/connections/sink.hpp>
 #include <src/core/network/simulationNetwork.hpp>
+#include <src/core/network/flowSolver.hpp>
+#include <src/core/network/compiledNetwork.hpp>
+#include <src/core/network/streamingYamlReader.hpp>
+#include <src/config/config.h>
 
 // Include your coordinate transform functions
 #include <src/math/coordinateSystemTransformations.hpp>
+#include <src/math/randomStream.hpp>
 
 // Include your receiver headers
 #include <src/core/receivers/sphericalReceiver.hpp>   // e.g. if you have "SphericalReceiver" there
@@ -35,512 +40,745 @@
 
 namespace {
 
-// A small helper to see if a YAML node is a sequence containing a target string
-bool hasStringInNode(const YAML::Node& node, const std::string& target) {
-    if (!node || !node.IsSequence()) return false;
-    for (auto& val : node) {
-        if (val.as<std::string>() == target) {
-            return true;
+enum class Side { LEFT, RIGHT };
+
+// Pipe sides are numbered 2 * pipe for the left end and 2 * pipe + 1 for the right end
+inline int sideIndex(int pipe, Side side) {
+    return 2 * pipe + (side == Side::RIGHT ? 1 : 0);
+}
+
+// Every name in the file (pipes, sinks and whatever the connections mention) gets an integer id when it is
+// first seen, so connections are resolved by indexing instead of by comparing strings
+class NameTable
+{
+private:
+    std::unordered_map<std::string, int> ids;
+    std::vector<std::string> names;
+
+public:
+    int intern(const std::string& name) {
+        auto inserted = ids.emplace(name, static_cast<int>(names.size()));
+        if (inserted.second) {
+            names.push_back(name);
         }
+        return inserted.first->second;
+    }
+    
+    int find(const std::string& name) const {
+        auto it = ids.find(name);
+        return it == ids.end() ? -1 : it->second;
     }
-    return false;
+    
+    const std::string& name(int id) const { return names[id]; }
+};
+
+// What an id stands for in a table indexed by name id, -1 if nothing
+inline int entryOf(const std::vector<int>& table, int id) {
+    return (id >= 0 && id < (int)table.size()) ? table[id] : -1;
 }
 
-enum class Side { LEFT, RIGHT };
+// The same, to be assigned: grows the table to take the id
+inline int& slotOf(std::vector<int>& table, int id) {
+    if (id >= (int)table.size()) {
+        table.resize(id + 1, -1);
+    }
+    return table[id];
+}
 
-// Return which side of `pipeNode` references `otherPipeName`
-std::optional<Side> findSideReferencing(const YAML::Node& pipeNode,
-                                        const std::string& otherPipeName)
+// The connections of one pipe as the YAML gives them, by name id
+struct PipeLinks
 {
-    if (hasStringInNode(pipeNode["left_connections"], otherPipeName)) {
+    int nameId = -1;
+    std::vector<int> left;
+    std::vector<int> right;
+    std::vector<int> sortedLeft; // the same, sorted, to find out which end of this pipe another pipe is on
+    std::vector<int> sortedRight;
+    double leftWeight = 1.0;
+    double rightWeight = 1.0;
+};
+
+// Which end of a pipe lists the pipe with the given name id, the left end first as it always was
+std::optional<Side> findSideReferencing(const PipeLinks& links, int otherNameId) {
+    if (std::binary_search(links.sortedLeft.begin(), links.sortedLeft.end(), otherNameId)) {
         return Side::LEFT;
     }
-    if (hasStringInNode(pipeNode["right_connections"], otherPipeName)) {
+    if (std::binary_search(links.sortedRight.begin(), links.sortedRight.end(), otherNameId)) {
         return Side::RIGHT;
     }
     return std::nullopt;
 }
 
-// Simple struct to represent a side of a pipe
-struct PipeSide
+std::vector<int> readConnectionIds(const YAML::Node& node, NameTable& names) {
+    std::vector<int> ids;
+    if (node && node.IsSequence()) {
+        ids.reserve(node.size());
+        for (auto& c : node) {
+            ids.push_back(names.intern(c.as<std::string>()));
+        }
+    }
+    return ids;
+}
+
+// Disjoint sets of pipe sides (union-find); every set of connected sides becomes one hub
+class SideSets
 {
-    Simulation* simulation;
-    Side        side;
-    std::string pipeName;
+private:
+    std::vector<int> parent;
+    std::vector<uint8_t> rank;
+
+public:
+    explicit SideSets(int count) : parent(count), rank(count, 0) {
+        for (int i = 0; i < count; ++i) {
+            parent[i] = i;
+        }
+    }
+    
+    int find(int side) {
+        while (parent[side] != side) {
+            parent[side] = parent[parent[side]]; // path halving
+            side = parent[side];
+        }
+        return side;
+    }
+    
+    void join(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (rank[a] < rank[b]) std::swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) rank[a]++;
+    }
 };
 
-} // end anonymous namespace
+// Reads the simulation: section, what it sets goes over the config.h defaults when the network is built
+void readSimulationSection(const YAML::Node& section, SimulationParameterOverrides& simulation) {
+    for (auto it = section.begin(); it != section.end(); ++it) {
+        std::string key = it->first.as<std::string>();
+        YAML::Node value = it->second;
+        
+        if (key == "time_to_run") {
+            simulation.timeToRun = value.as<double>();
+        } else if (key == "dt") {
+            simulation.dt = value.as<double>();
+        } else if (key == "diffusion_coefficient") {
+            simulation.diffusionCoefficient = value.as<double>();
+        } else if (key == "iterations_per_frame") {
+            simulation.iterationsPerFrame = value.as<int>();
+        } else if (key == "first_passage_jumps") {
+            simulation.firstPassageJumps = value.as<bool>();
+        } else if (key == "first_passage_safety") {
+            simulation.firstPassageSafety = value.as<double>();
+        } else if (key == "first_passage_max_steps") {
+            simulation.firstPassageMaxSteps = value.as<int>();
+        } else {
+            // mode, graphics and bulk mode choose what main runs, so they come from the command line
+            std::cerr << "[Warning] Unknown simulation parameter: " << key << ", ignoring.\n";
+        }
+    }
+}
 
-std::unique_ptr<SimulationNetwork>
-SimulationNetworkLoader::loadFromYAML(const std::string& filename)
-{
-    YAML::Node config = YAML::LoadFile(filename);
-    auto network = std::make_unique<SimulationNetwork>();
+// Reads the top-level hub_routing: key
+HubRouting readHubRouting(const YAML::Node& node) {
+    std::string name = node.as<std::string>();
+    if (name == "radius_squared") return HubRouting::RADIUS_SQUARED;
+    if (name == "poiseuille") return HubRouting::POISEUILLE;
+    if (name == "weights") return HubRouting::WEIGHTS;
+    if (name == "flux") return HubRouting::FLUX;
+    throw std::runtime_error("Unknown hub_routing: " + name + " (expected radius_squared, poiseuille, weights or flux)");
+}
 
-    // ------------------------------------------------------------------------
-    // 1) Read all "pipes" and build Simulation objects.
-    // ------------------------------------------------------------------------
-    std::unordered_map<std::string, std::unique_ptr<Simulation>> simulations;
-    simulations.reserve(config["pipes"].size());
+// Routing weight of one side of a pipe, from its left_weight / right_weight key
+double readSideWeight(const YAML::Node& pipeNode, Side side, const std::string& pipeName) {
+    const char* key = (side == Side::LEFT) ? "left_weight" : "right_weight";
+    if (!pipeNode[key]) {
+        return 1.0;
+    }
+    double weight = pipeNode[key].as<double>();
+    if (weight < 0) {
+        throw std::runtime_error(pipeName + ": " + key + " must not be negative");
+    }
+    return weight;
+}
 
-    // Store the YAML node for each pipe for later lookups
-    std::unordered_map<std::string, YAML::Node> pipeNodes;
-    pipeNodes.reserve(config["pipes"].size());
+// Reads one entry of a pipe's receivers: list, false if it is skipped
+bool describeReceiver(const YAML::Node& rcv, const PipeDescription& pipe, ReceiverDescription& receiver) {
+    if (!rcv["type"]) {
+        std::cerr << "[Warning] A receiver is missing its 'type' field, skipping.\n";
+        return false;
+    }
 
-    for (auto it = config["pipes"].begin(); it != config["pipes"].end(); ++it) {
-        std::string pipeName = it->first.as<std::string>();
-        const auto& pipeCfg  = it->second;
+    std::string receiverType = rcv["type"].as<std::string>();
 
-        double length = pipeCfg["length"].as<double>();
-        double radius = pipeCfg["radius"].as<double>();
-        int particleCount = pipeCfg["particle_count"] ? pipeCfg["particle_count"].as<int>() : 100;
-        double flow = pipeCfg["flow"] ? pipeCfg["flow"].as<double>() : 0.0;
+    receiver.name = rcv["name"] ? rcv["name"].as<std::string>() : "";
+    receiver.countingType = rcv["countingType"] ? rcv["countingType"].as<int>() : 0;
 
-        // Create the simulation
-        glm::dvec3 flowVector(0.0, 0.0, flow);
-        auto sim = std::make_unique<Simulation>(particleCount, radius, length, flowVector);
-        
-        // Set the name of the simulation to the pipe name from YAML
-        sim->setName(pipeName);
-        
-        // Set default parentName to "none"
-        sim->setParentName("none");
+    // Default to 0 if missing
+    double z     = rcv["z"]     ? rcv["z"].as<double>()     : 0.0;
+    double rCyl  = rcv["r"]     ? rcv["r"].as<double>()     : 0.0;
+    double theta = rcv["theta"] ? rcv["theta"].as<double>() : 0.0;
 
-        // Keep track of the simulation and its node
-        simulations[pipeName] = std::move(sim);
-        pipeNodes[pipeName]   = pipeCfg;
+    if (receiverType == "Sphere type") {
+        // We expect radius, z, r, theta
+        receiver.kind = ReceiverKind::SPHERE;
+        if (rcv["radius"]) {
+            receiver.radius = rcv["radius"].as<double>();
+        } else {
+            std::cerr << "[Warning] Sphere receiver has no 'radius'. Defaulting to 1e-6\n";
+            receiver.radius = 1e-6;
+        }
+
+        // Convert from cylindrical -> cartesian
+        receiver.position = cylindricalToCartesian(glm::dvec3(rCyl, theta, z));
+    }
+    else if (receiverType == "Ring type") {
+        receiver.kind = ReceiverKind::RING;
+        receiver.position = cylindricalToCartesian(glm::dvec3(rCyl, theta, z));
     }
+    else if(receiverType == "Ring type with thickness") {
+        receiver.kind = ReceiverKind::RING_WITH_THICKNESS;
+        receiver.thickness = rcv["thickness"] ? rcv["thickness"].as<double>() : 0.0;
+        receiver.position = cylindricalToCartesian(glm::dvec3(rCyl, theta, z));
+    }
+    else if(receiverType == "Trap type") {
+        receiver.kind = ReceiverKind::TRAP;
+        receiver.length = rcv["length"] ? rcv["length"].as<double>() : 0.0;
+        receiver.theta = theta;
+        receiver.deltaTheta = rcv["delta_theta"] ? rcv["delta_theta"].as<double>() : 0.0;
+        receiver.thickness = rcv["thickness"] ? rcv["thickness"].as<double>() : 0.0;
+
+        // The trap lies on the wall, so it gets the radius of the pipe
+        receiver.radius = pipe.radius;
+        receiver.position = cylindricalToCartesian(glm::dvec3(0, theta, z));
+    }
+    else {
+        std::cerr << "[Warning] Unknown receiver type: " << receiverType
+                  << " for pipe: " << pipe.name << ", skipping.\n";
+        return false;
+    }
+    return true;
+}
 
-    // Read the flow value from the config file
-    double flow = config["flow"] ? config["flow"].as<double>() : 0.0;
-    network->setFlowValue(flow);
+// Reads one entry of a pipe's emitters: list, false if it is skipped
+bool describeEmitter(const YAML::Node& emitterCfg, const PipeDescription& pipe, EmitterDescription& emitter) {
+    const std::string& pipeName = pipe.name;
+
+    // Parse emitter coordinates from cylindrical to cartesian
+    double z = emitterCfg["z"] ? emitterCfg["z"].as<double>() : 0.0;
+    double rCyl = emitterCfg["r"] ? emitterCfg["r"].as<double>() : 0.0;
+    double theta = emitterCfg["theta"] ? emitterCfg["theta"].as<double>() : 0.0;
+    emitter.position = cylindricalToCartesian(glm::dvec3(rCyl, theta, z));
+
+    // The emitter type (defaults to "pattern" if not specified)
+    std::string emitterType = emitterCfg["emitter_type"] ? emitterCfg["emitter_type"].as<std::string>() : "pattern";
+    emitter.start = emitterCfg["start"] ? emitterCfg["start"].as<double>() : 0.0;
+    if (emitterType == "poisson") {
+        emitter.kind = EmissionKind::POISSON;
+        emitter.rate = emitterCfg["rate"] ? emitterCfg["rate"].as<double>() : 0.0;
+        emitter.stop = emitterCfg["stop"] ? emitterCfg["stop"].as<double>() : 0.0;
+        if (!(emitter.rate > 0.0)) {
+            std::cerr << "[Warning] Poisson emitter in pipe: " << pipeName
+                      << " needs a positive rate. Skipping.\n";
+            return false;
+        }
+        return true;
+    }
+    if (emitterType == "pulse_train") {
+        emitter.kind = EmissionKind::PULSE_TRAIN;
+        emitter.count = emitterCfg["count"] ? emitterCfg["count"].as<int>() : 0;
+        emitter.period = emitterCfg["period"] ? emitterCfg["period"].as<double>() : 0.0;
+        emitter.pulses = emitterCfg["pulses"] ? emitterCfg["pulses"].as<int>() : 0;
+        if (emitter.count <= 0 || emitter.pulses < 0 || (!(emitter.period > 0.0) && emitter.pulses != 1)) {
+            std::cerr << "[Warning] Pulse train emitter in pipe: " << pipeName
+                      << " needs a positive count, and a positive period unless pulses is 1. Skipping.\n";
+            return false;
+        }
+        return true;
+    }
+    if (emitterType != "pattern") {
+        std::cerr << "[Warning] Invalid emitter type: " << emitterType
+                  << " in pipe: " << pipeName << ". Skipping.\n";
+        return false;
+    }
 
-    // ------------------------------------------------------------------------
-    // 1.5) Read all "sinks" and build Sink objects.
-    // ------------------------------------------------------------------------
-    std::unordered_map<std::string, std::unique_ptr<Sink>> sinks;
-    std::unordered_map<std::string, YAML::Node> sinkNodes;
-    
-    if (config["sinks"]) {
-        sinks.reserve(config["sinks"].size());
-        sinkNodes.reserve(config["sinks"].size());
+    // Parse emitter pattern
+    if (emitterCfg["emitter_pattern"]) {
+        std::string patternStr = emitterCfg["emitter_pattern"].as<std::string>();
+        std::stringstream ss(patternStr);
+        std::string item;
         
-        for (auto it = config["sinks"].begin(); it != config["sinks"].end(); ++it) {
-            std::string sinkName = it->first.as<std::string>();
-            const auto& sinkCfg = it->second;
-            
-            // Create the sink
-            auto sink = std::make_unique<Sink>();
-            
-            // Set the name of the sink
-            sink->setName(sinkName);
-            
-            // Keep track of the sink and its node
-            sinks[sinkName] = std::move(sink);
-            sinkNodes[sinkName] = sinkCfg;
+        // Parse comma-separated values into integer vector
+        while (std::getline(ss, item, ',')) {
+            try {
+                emitter.pattern.push_back(std::stoi(item));
+            } catch (const std::exception& e) {
+                std::cerr << "[Warning] Invalid emitter pattern value: " << item
+                          << " in pipe: " << pipeName << ". Skipping.\n";
+            }
         }
     }
 
-    // ------------------------------------------------------------------------
-    // 2) Create a graph of "pipe sides": each pipe has a left side & right side.
-    // ------------------------------------------------------------------------
-    std::vector<PipeSide> sideMapping;   // index => PipeSide
-    sideMapping.reserve(simulations.size() * 2);
+    // Get the pattern type (defaults to "repeat" if not specified)
+    emitter.patternType = "repeat";
+    if (emitterCfg["emitter_pattern_type"]) {
+        emitter.patternType = emitterCfg["emitter_pattern_type"].as<std::string>();
+        // Validate pattern type
+        if (emitter.patternType != "repeat" && emitter.patternType != "complete") {
+            std::cerr << "[Warning] Invalid emitter pattern type: " << emitter.patternType
+                       << " in pipe: " << pipeName << ". Defaulting to 'repeat'.\n";
+            emitter.patternType = "repeat";
+        }
+    }
 
-    // We'll map pipeName -> indices
-    std::unordered_map<std::string, int> leftIndexOf;
-    std::unordered_map<std::string, int> rightIndexOf;
+    if (emitter.pattern.empty()) {
+        std::cerr << "[Warning] Emitter in pipe: " << pipeName
+                  << " has no valid emission pattern. Skipping.\n";
+        return false;
+    }
+    return true;
+}
 
-    {
-        int idx = 0;
-        for (auto& kv : simulations) {
-            const std::string& pipeName = kv.first;
-            Simulation* simPtr         = kv.second.get();
+} // end anonymous namespace
 
-            // left side
-            leftIndexOf[pipeName] = idx;
-            sideMapping.push_back({ simPtr, Side::LEFT, pipeName });
-            idx++;
+std::unique_ptr<SimulationNetwork>
+SimulationNetworkLoader::loadFromYAML(const std::string& filename, std::optional<uint64_t> defaultSeed,
+                                      const SimulationParameterOverrides& overrides)
+{
+    return buildNetwork(loadDescription(filename), filename, defaultSeed, overrides);
+}
 
-            // right side
-            rightIndexOf[pipeName] = idx;
-            sideMapping.push_back({ simPtr, Side::RIGHT, pipeName });
-            idx++;
+NetworkDescription SimulationNetworkLoader::loadDescription(const std::string& filename, bool writeCache)
+{
+    if (!NETWORK_CACHE) {
+        return describeYAML(filename);
+    }
+    
+    // The compiled network next to the config is used as long as it was compiled from exactly these bytes
+    ConfigFingerprint fingerprint = fingerprintConfigFile(filename);
+    std::string cachePath = compiledNetworkPath(filename);
+    std::optional<NetworkDescription> description = readCompiledNetwork(cachePath, fingerprint);
+    if (!description) {
+        description = describeYAML(filename);
+        // Not being able to write it (a read-only config directory) only costs the next run the YAML again
+        if (writeCache) {
+            writeCompiledNetwork(cachePath, fingerprint, *description);
         }
     }
+    return std::move(*description);
+}
 
-    // Adjacency list for all sides
-    std::vector<std::vector<int>> adjacency(sideMapping.size());
+NetworkDescription SimulationNetworkLoader::describeYAML(const std::string& filename)
+{
+    NetworkDescription description;
+    std::vector<PipeDescription>& pipes = description.pipes;
+    std::vector<PipeLinks> links; // same indices as pipes
 
-    // Helper to connect two sides
-    auto addConnection = [&](int a, int b) {
-        adjacency[a].push_back(b);
-        adjacency[b].push_back(a);
-    };
+    NameTable names;
+    std::vector<int> pipeOfName; // name id -> index into pipes
+    std::vector<int> sinkOfName; // name id -> index into description.sinks
 
     // ------------------------------------------------------------------------
-    // 3) Build adjacency by reading each pipe's left/right connections.
+    // 1) Stream the "pipes" and "sinks", one entry at a time, in the order of the file
     // ------------------------------------------------------------------------
-    for (auto& kv : pipeNodes) {
-        const std::string& pipeName = kv.first;
-        const auto& node            = kv.second;
-
-        int leftNodeIndex  = leftIndexOf.at(pipeName);
-        int rightNodeIndex = rightIndexOf.at(pipeName);
-
-        // left_connections
-        if (node["left_connections"] && node["left_connections"].IsSequence()) {
-            for (auto& c : node["left_connections"]) {
-                std::string otherPipe = c.as<std::string>();
-                
-                // Check if it's a sink connection
-                if (sinks.find(otherPipe) != sinks.end()) {
-                    // Skip sink connections for left side as they are handled separately
-                    continue;
+    auto readEntry = [&](const std::string& section, const std::string& name, const YAML::Node& node) {
+        int nameId = names.intern(name);
+        
+        if (section == "sinks") {
+            int& sink = slotOf(sinkOfName, nameId);
+            if (sink < 0) {
+                sink = static_cast<int>(description.sinks.size());
+                description.sinks.push_back(name);
+            }
+            return;
+        }
+        
+        PipeDescription pipe;
+        pipe.name = name;
+        pipe.parentName = "none";
+        pipe.length = node["length"].as<double>();
+        pipe.radius = node["radius"].as<double>();
+        pipe.particleCount = node["particle_count"] ? node["particle_count"].as<int>() : 100;
+        pipe.flow = node["flow"] ? node["flow"].as<double>() : 0.0;
+        
+        PipeLinks pipeLinks;
+        pipeLinks.nameId = nameId;
+        pipeLinks.left = readConnectionIds(node["left_connections"], names);
+        pipeLinks.right = readConnectionIds(node["right_connections"], names);
+        pipeLinks.sortedLeft = pipeLinks.left;
+        pipeLinks.sortedRight = pipeLinks.right;
+        std::sort(pipeLinks.sortedLeft.begin(), pipeLinks.sortedLeft.end());
+        std::sort(pipeLinks.sortedRight.begin(), pipeLinks.sortedRight.end());
+        pipeLinks.leftWeight = readSideWeight(node, Side::LEFT, name);
+        pipeLinks.rightWeight = readSideWeight(node, Side::RIGHT, name);
+        
+        if (node["receivers"] && node["receivers"].IsSequence()) {
+            for (auto& rcv : node["receivers"]) {
+                ReceiverDescription receiver;
+                if (describeReceiver(rcv, pipe, receiver)) {
+                    pipe.receivers.push_back(std::move(receiver));
                 }
-                
-                auto sideOpt = findSideReferencing(pipeNodes[otherPipe], pipeName);
-                if (!sideOpt.has_value()) {
-                    std::cerr << "[Warning] " << pipeName << ":left -> " << otherPipe
-                              << " but " << otherPipe << " does not reference " << pipeName << "!\n";
-                    continue;
+            }
+        }
+        if (node["emitters"] && node["emitters"].IsSequence()) {
+            for (auto& emitterCfg : node["emitters"]) {
+                EmitterDescription emitter;
+                if (describeEmitter(emitterCfg, pipe, emitter)) {
+                    pipe.emitters.push_back(std::move(emitter));
                 }
-                int otherIndex = (sideOpt.value() == Side::LEFT)
-                    ? leftIndexOf.at(otherPipe)
-                    : rightIndexOf.at(otherPipe);
-
-                addConnection(leftNodeIndex, otherIndex);
-                
-                // Set the parentName to the name of the simulation connected to the left side
-                simulations[pipeName]->setParentName(otherPipe);
             }
         }
+        
+        int& index = slotOf(pipeOfName, nameId);
+        if (index >= 0) {
+            std::cerr << "[Warning] Pipe " << name << " is defined more than once, using the last one.\n";
+            pipes[index] = std::move(pipe);
+            links[index] = std::move(pipeLinks);
+            return;
+        }
+        index = static_cast<int>(pipes.size());
+        pipes.push_back(std::move(pipe));
+        links.push_back(std::move(pipeLinks));
+    };
+    
+    StreamingYamlReader reader({ "pipes", "sinks" }, readEntry);
+    reader.readFile(filename);
+    const YAML::Node& config = reader.getTopLevel();
 
-        // right_connections
-        if (node["right_connections"] && node["right_connections"].IsSequence()) {
-            for (auto& c : node["right_connections"]) {
-                std::string otherPipe = c.as<std::string>();
-                
-                // Check if it's a sink connection
-                if (sinks.find(otherPipe) != sinks.end()) {
-                    // Skip sink connections for now as they are handled separately
+    if (config["seed"]) {
+        description.seed = config["seed"].as<uint64_t>();
+    }
+    if (config["simulation"]) {
+        readSimulationSection(config["simulation"], description.simulation);
+    }
+    
+    // Read the flow value from the config file
+    description.flowValue = config["flow"] ? config["flow"].as<double>() : 0.0;
+
+    // ------------------------------------------------------------------------
+    // 2) Resolve the connections: sides that reference each other are joined
+    // ------------------------------------------------------------------------
+    int pipeCount = static_cast<int>(pipes.size());
+    SideSets sides(2 * pipeCount);
+    std::vector<int> sinkOfPipe(pipeCount, -1); // sink on the right end of a pipe
+
+    for (int p = 0; p < pipeCount; ++p) {
+        for (Side side : { Side::LEFT, Side::RIGHT }) {
+            const std::vector<int>& connections = (side == Side::LEFT) ? links[p].left : links[p].right;
+            for (int otherId : connections) {
+                // A sink on the right end takes that end over from its hub, on the left end sinks are skipped
+                int sink = entryOf(sinkOfName, otherId);
+                if (sink >= 0) {
+                    if (side == Side::RIGHT) {
+                        sinkOfPipe[p] = sink;
+                    }
                     continue;
                 }
                 
-                auto sideOpt = findSideReferencing(pipeNodes[otherPipe], pipeName);
-                if (!sideOpt.has_value()) {
-                    std::cerr << "[Warning] " << pipeName << ":right -> " << otherPipe
-                              << " but " << otherPipe << " does not reference " << pipeName << "!\n";
+                int other = entryOf(pipeOfName, otherId);
+                std::optional<Side> otherSide;
+                if (other >= 0) {
+                    otherSide = findSideReferencing(links[other], links[p].nameId);
+                }
+                if (!otherSide.has_value()) {
+                    std::cerr << "[Warning] " << pipes[p].name << (side == Side::LEFT ? ":left -> " : ":right -> ")
+                              << names.name(otherId) << " but " << names.name(otherId)
+                              << " does not reference " << pipes[p].name << "!\n";
                     continue;
                 }
-                int otherIndex = (sideOpt.value() == Side::LEFT)
-                    ? leftIndexOf.at(otherPipe)
-                    : rightIndexOf.at(otherPipe);
-
-                addConnection(rightNodeIndex, otherIndex);
+                sides.join(sideIndex(p, side), sideIndex(other, otherSide.value()));
+                
+                // Set the parentName to the name of the simulation connected to the left side
+                if (side == Side::LEFT) {
+                    pipes[p].parentName = names.name(otherId);
+                }
             }
         }
     }
 
     // ------------------------------------------------------------------------
-    // 4) Find connected components -> create Hubs
+    // 3) Every set of joined sides is a Hub, numbered by its first side
     // ------------------------------------------------------------------------
-    std::vector<bool> visited(sideMapping.size(), false);
-    std::vector<std::unique_ptr<Hub>> allHubs;
-    allHubs.reserve(sideMapping.size());
-
-    for (int start = 0; start < (int)sideMapping.size(); ++start) {
-        if (visited[start]) continue;
-
-        // BFS or DFS from 'start' to find all connected sides
-        std::queue<int> q;
-        q.push(start);
-        visited[start] = true;
-
-        std::vector<int> component;
-        component.reserve(4);
-
-        while (!q.empty()) {
-            int curr = q.front();
-            q.pop();
-            component.push_back(curr);
-
-            for (int nxt : adjacency[curr]) {
-                if (!visited[nxt]) {
-                    visited[nxt] = true;
-                    q.push(nxt);
-                }
-            }
-        }
-
-        // Build one hub for this connected component
-        auto hubPtr = std::make_unique<Hub>();
-
-        // Wire up each side in the component to that hub
-        for (int nodeIndex : component) {
-            const auto& ps = sideMapping[nodeIndex];
-            if (ps.side == Side::LEFT) {
-                ps.simulation->setLeftConnection(hubPtr.get());
-                hubPtr->addDirectedConnection({ ps.simulation, Direction::LEFT });
-            } else {
-                ps.simulation->setRightConnection(hubPtr.get());
-                hubPtr->addDirectedConnection({ ps.simulation, Direction::RIGHT });
-            }
+    HubRouting hubRouting = config["hub_routing"] ? readHubRouting(config["hub_routing"]) : HubRouting::RADIUS_SQUARED;
+    
+    std::vector<int> hubOfRoot(2 * pipeCount, -1);
+    std::vector<int> hubOfSide(2 * pipeCount); // index into description.hubs
+    for (int s = 0; s < 2 * pipeCount; ++s) {
+        int& hubIndex = hubOfRoot[sides.find(s)];
+        if (hubIndex < 0) {
+            hubIndex = static_cast<int>(description.hubs.size());
+            description.hubs.emplace_back();
+            description.hubs.back().routing = hubRouting;
         }
-
-        allHubs.push_back(std::move(hubPtr));
+        hubOfSide[s] = hubIndex;
+        
+        int p = s / 2;
+        bool left = (s % 2 == 0);
+        description.hubs[hubIndex].branches.push_back({ p, left ? Direction::LEFT : Direction::RIGHT,
+                                                        left ? links[p].leftWeight : links[p].rightWeight });
+        (left ? pipes[p].left : pipes[p].right) = { ConnectionKind::HUB, hubIndex };
     }
-
-    // ------------------------------------------------------------------------
-    // 4.5) Connect sink nodes to pipes
-    // ------------------------------------------------------------------------
-    for (auto& kv : pipeNodes) {
-        const std::string& pipeName = kv.first;
-        const auto& node = kv.second;
-        Simulation* simPtr = simulations[pipeName].get();
-
-        // Check right connections for sink nodes
-        if (node["right_connections"] && node["right_connections"].IsSequence()) {
-            for (auto& c : node["right_connections"]) {
-                std::string otherName = c.as<std::string>();
-                
-                // Check if it's a sink connection
-                if (sinks.find(otherName) != sinks.end()) {
-                    // Connect the sink to the right side of the pipe
-                    simPtr->setRightConnection(sinks[otherName].get());
-                }
+    
+    // The hub's stream is named after the pipe sides it joins, sorted so load order does not matter
+    for (auto& hub : description.hubs) {
+        std::vector<std::string> sideNames;
+        sideNames.reserve(hub.branches.size());
+        for (const auto& branch : hub.branches) {
+            sideNames.push_back(pipes[branch.pipe].name + (branch.direction == Direction::LEFT ? ":left" : ":right"));
+        }
+        std::sort(sideNames.begin(), sideNames.end());
+        std::string hubName = "hub";
+        for (const auto& sideName : sideNames) {
+            hubName += "|" + sideName;
+        }
+        hub.streamId = streamIdFromName(hubName);
+        
+        // With every weight at 0 the alias table is empty and particles reaching the hub would silently vanish
+        if (hub.routing == HubRouting::WEIGHTS
+            && std::all_of(hub.branches.begin(), hub.branches.end(),
+                           [](const HubBranch& branch) { return branch.weight <= 0; })) {
+            std::string joined;
+            for (const auto& sideName : sideNames) {
+                joined += (joined.empty() ? "" : ", ") + sideName;
             }
+            throw std::runtime_error("hub_routing: weights: every weight is 0 at the hub joining " + joined);
         }
     }
 
     // ------------------------------------------------------------------------
-    // 5) Initialize the hubs
+    // 4) Connect sink nodes to pipes
     // ------------------------------------------------------------------------
-    for (auto& hub : allHubs) {
-        hub->initializeProbabilities();
+    for (int p = 0; p < pipeCount; ++p) {
+        if (sinkOfPipe[p] >= 0) {
+            pipes[p].right = { ConnectionKind::SINK, sinkOfPipe[p] };
+        }
     }
 
     // ------------------------------------------------------------------------
-    // 6) Parse "receivers" for each pipe, if present
+    // 5) Solve the pipe flows, if the config asks for it
     // ------------------------------------------------------------------------
-    for (auto& kv : simulations) {
-        const std::string& pipeName = kv.first;
-        Simulation* simPtr          = kv.second.get();
-
-        // Look up the original YAML node
-        const auto& pipeCfg = pipeNodes[pipeName];
-        if (!pipeCfg["receivers"] || !pipeCfg["receivers"].IsSequence()) {
-            // no receivers for this pipe
-            continue;
-        }
-
-        // For each receiver definition
-        for (auto& rcv : pipeCfg["receivers"]) {
-            if (!rcv["type"]) {
-                std::cerr << "[Warning] A receiver is missing its 'type' field, skipping.\n";
-                continue;
+    if (config["flow_solver"]) {
+        const YAML::Node& solverCfg = config["flow_solver"];
+        
+        // One node per hub and per sink, numbered as they are first met going through the pipes by name,
+        // so the same network always gives the same FlowNetwork (and hits the solver's cache)
+        std::vector<int> pipesByName(pipeCount);
+        for (int p = 0; p < pipeCount; ++p) {
+            pipesByName[p] = p;
+        }
+        std::sort(pipesByName.begin(), pipesByName.end(), [&](int a, int b) { return pipes[a].name < pipes[b].name; });
+        
+        FlowNetwork flowNetwork;
+        std::vector<int> hubNode(description.hubs.size(), -1);
+        std::vector<int> sinkNode(description.sinks.size(), -1);
+        auto nodeOf = [&](int& node) {
+            if (node < 0) {
+                node = flowNetwork.addNode();
             }
-
-            std::string receiverType = rcv["type"].as<std::string>();
-
-            if (receiverType == "Sphere type") {
-                // We expect radius, z, r, theta
-                double radius = 0.0;
-                if (rcv["radius"]) {
-                    radius = rcv["radius"].as<double>();
-                } else {
-                    std::cerr << "[Warning] Sphere receiver has no 'radius'. Defaulting to 1e-6\n";
-                    radius = 1e-6;
-                }
-
-                // Default to 0 if missing
-                double z     = rcv["z"]     ? rcv["z"].as<double>()     : 0.0;
-                double rCyl  = rcv["r"]     ? rcv["r"].as<double>()     : 0.0;
-                double theta = rcv["theta"] ? rcv["theta"].as<double>() : 0.0;
-                
-                int countingType = rcv["countingType"] ? rcv["countingType"].as<int>() : 0;
-
-                // Convert from cylindrical -> cartesian
-                glm::dvec3 cylPos(rCyl, theta, z);
-                glm::dvec3 cartPos = cylindricalToCartesian(cylPos);
-
-                // Create a spherical receiver
-                auto sphere = std::make_unique<SphericalReceiver>(cartPos, countingType, radius);
-                
-                // Set the name if it exists in the YAML
-                if (rcv["name"]) {
-                    sphere->setName(rcv["name"].as<std::string>());
-                }
-
-                // Add it to the simulation
-                simPtr->addReceiver(std::move(sphere));
+            return node;
+        };
+        auto sideNode = [&](int p, Side side) {
+            if (side == Side::RIGHT && sinkOfPipe[p] >= 0) {
+                return nodeOf(sinkNode[sinkOfPipe[p]]);
             }
-            else if (receiverType == "Ring type") {
-                // Example usage for a "Ring type" receiver
-                // You can define your own constructor / usage
-                double z     = rcv["z"] ? rcv["z"].as<double>() : 0.0;
-                // Possibly you want r, theta, or other fields as well.
-                // For example:
-                double rCyl  = rcv["r"]     ? rcv["r"].as<double>()     : 0.0;
-                double theta = rcv["theta"] ? rcv["theta"].as<double>() : 0.0;
-                
-                int countingType = rcv["countingType"] ? rcv["countingType"].as<int>() : 0;
-
-                glm::dvec3 cylPos(rCyl, theta, z);
-                glm::dvec3 cartPos = cylindricalToCartesian(cylPos);
+            return nodeOf(hubNode[hubOfSide[sideIndex(p, side)]]);
+        };
+        
+        for (int p : pipesByName) {
+            // length in the config is the half length of the pipe
+            flowNetwork.addPipe(sideNode(p, Side::LEFT), sideNode(p, Side::RIGHT), pipes[p].radius, 2 * pipes[p].length);
+        }
+        
+        // Boundaries are named by pipe side ("pipe1:left") or by sink
+        auto boundaryNode = [&](const std::string& name) {
+            int sink = entryOf(sinkOfName, names.find(name));
+            if (sink >= 0) {
+                return nodeOf(sinkNode[sink]);
+            }
+            size_t colon = name.rfind(':');
+            int p = entryOf(pipeOfName, names.find(name.substr(0, colon)));
+            std::string sideName = colon == std::string::npos ? "" : name.substr(colon + 1);
+            if (p < 0 || (sideName != "left" && sideName != "right")) {
+                throw std::runtime_error("flow_solver: unknown boundary " + name + " (expected pipe:left, pipe:right or a sink)");
+            }
+            return sideNode(p, sideName == "left" ? Side::LEFT : Side::RIGHT);
+        };
+        
+        if (solverCfg["viscosity"]) {
+            flowNetwork.viscosity = solverCfg["viscosity"].as<double>();
+        }
+        for (auto it = solverCfg["pressures"].begin(); it != solverCfg["pressures"].end(); ++it) {
+            flowNetwork.nodePressure[boundaryNode(it->first.as<std::string>())] = it->second.as<double>();
+        }
+        for (auto it = solverCfg["inflows"].begin(); it != solverCfg["inflows"].end(); ++it) {
+            flowNetwork.nodeInflow[boundaryNode(it->first.as<std::string>())] += it->second.as<double>();
+        }
+        
+        // The solved flows replace the per-pipe flow values
+        FlowSolution solution = FlowSolver::solve(flowNetwork);
+        for (int i = 0; i < pipeCount; ++i) {
+            PipeDescription& pipe = pipes[pipesByName[i]];
+            pipe.flow = FlowSolver::centrelineVelocity(solution.pipeFlow[i], pipe.radius);
+        }
+    }
 
-                // Create your "Ring type" receiver – placeholder name:
-                auto ring = std::make_unique<RingReceiver>(cartPos, countingType, 2);
-                
-                // Set the name if it exists in the YAML
-                if (rcv["name"]) {
-                    ring->setName(rcv["name"].as<std::string>());
-                }
+    return description;
+}
 
-                simPtr->addReceiver(std::move(ring));
-            }
-            else if(receiverType == "Ring type with thickness") {
-                double z = rcv["z"] ? rcv["z"].as<double>() : 0.0;
-                double rCyl = rcv["r"] ? rcv["r"].as<double>() : 0.0;
-                double theta = rcv["theta"] ? rcv["theta"].as<double>() : 0.0;
-                double thickness = rcv["thickness"] ? rcv["thickness"].as<double>() : 0.0;
-                
-                int countingType = rcv["countingType"] ? rcv["countingType"].as<int>() : 0;
-                
-                glm::dvec3 cylPos(rCyl, theta, z);
-                glm::dvec3 cartPos = cylindricalToCartesian(cylPos);
-                
-                auto ring = std::make_unique<RingReceiverWithThickness>(cartPos, countingType, 2, thickness);
-                
-                if (rcv["name"]) {
-                    ring->setName(rcv["name"].as<std::string>());
-                }
+std::unique_ptr<SimulationNetwork>
+SimulationNetworkLoader::buildNetwork(const NetworkDescription& description, const std::string& sourceName,
+                                      std::optional<uint64_t> defaultSeed, const SimulationParameterOverrides& overrides)
+{
+    auto network = std::make_unique<SimulationNetwork>();
 
-                simPtr->addReceiver(std::move(ring));
-            }
-            else if(receiverType == "Trap type") {
-                double length = rcv["length"] ? rcv["length"].as<double>() : 0.0;
-                double theta = rcv["theta"] ? rcv["theta"].as<double>() : 0.0;
-                double delta_theta = rcv["delta_theta"] ? rcv["delta_theta"].as<double>() : 0.0;
-                double thickness = rcv["thickness"] ? rcv["thickness"].as<double>() : 0.0;
-                double z = rcv["z"] ? rcv["z"].as<double>() : 0.0;
-                
-                int countingType = rcv["countingType"] ? rcv["countingType"].as<int>() : 0;
+    // Every random stream of the run is derived from this seed.
+    // Without one in the YAML the run gets the caller's default, or else a fresh seed, printed so the run can be repeated.
+    uint64_t seed;
+    if (description.seed) {
+        seed = *description.seed;
+    } else if (defaultSeed) {
+        seed = *defaultSeed;
+    } else {
+        seed = generateRandomSeed();
+        std::cout << "No seed in " << sourceName << ", using seed: " << seed << std::endl;
+    }
+    network->setSeed(seed);
+    
+    SimulationParameters parameters;
+    description.simulation.applyTo(parameters);
+    if (parameters.dt <= 0 || parameters.timeToRun <= 0 || parameters.iterationsPerFrame <= 0) {
+        throw std::runtime_error("simulation: dt, time_to_run and iterations_per_frame must be positive");
+    }
+    if (parameters.firstPassageSafety <= 0 || parameters.firstPassageMaxSteps <= 0) {
+        throw std::runtime_error("simulation: first_passage_safety and first_passage_max_steps must be positive");
+    }
+    overrides.applyTo(parameters);
+    network->setParameters(parameters);
+    network->setFlowValue(description.flowValue);
 
-                //here i want to give the radius of the simulation to the trap receiver
-                double radius = simPtr->getBoundaryRadius();
-                
+    // ------------------------------------------------------------------------
+    // 1) Build the Simulation objects and the sinks
+    // ------------------------------------------------------------------------
+    std::vector<std::unique_ptr<Simulation>> simulations;
+    simulations.reserve(description.pipes.size());
+    for (const auto& pipe : description.pipes) {
+        glm::dvec3 flowVector(0.0, 0.0, pipe.flow);
+        auto sim = std::make_unique<Simulation>(pipe.particleCount, pipe.radius, pipe.length, flowVector, parameters);
+        sim->setName(pipe.name);
+        sim->setParentName(pipe.parentName);
+        sim->seedRandomStreams(seed);
+        simulations.push_back(std::move(sim));
+    }
 
-                glm::dvec3 cylPos(0, theta, z);
-                glm::dvec3 cartPos = cylindricalToCartesian(cylPos);
+    std::vector<std::unique_ptr<Sink>> sinks;
+    sinks.reserve(description.sinks.size());
+    for (const auto& sinkName : description.sinks) {
+        auto sink = std::make_unique<Sink>();
+        sink->setName(sinkName);
+        sinks.push_back(std::move(sink));
+    }
 
-                // Create a trap receiver
-                auto trap = std::make_unique<TrapReceiver>(cartPos, countingType, radius, length, theta, delta_theta, thickness);
-                
-                // Set the name if it exists in the YAML
-                if (rcv["name"]) {
-                    trap->setName(rcv["name"].as<std::string>());
-                }
+    // ------------------------------------------------------------------------
+    // 2) Build the hubs and connect both ends of every pipe
+    // ------------------------------------------------------------------------
+    std::vector<std::unique_ptr<Hub>> hubs;
+    hubs.reserve(description.hubs.size());
+    for (const auto& hubDescription : description.hubs) {
+        auto hub = std::make_unique<Hub>();
+        hub->setRouting(hubDescription.routing);
+        for (const auto& branch : hubDescription.branches) {
+            hub->addDirectedConnection({ simulations[branch.pipe].get(), branch.direction, branch.weight });
+        }
+        hub->setRandomStream(RandomStream(seed, hubDescription.streamId));
+        hubs.push_back(std::move(hub));
+    }
 
-                simPtr->addReceiver(std::move(trap));
-            }
-            else {
-                std::cerr << "[Warning] Unknown receiver type: " << receiverType
-                          << " for pipe: " << pipeName << ", skipping.\n";
-            }
+    auto connectionOf = [&](const ConnectionReference& reference) -> Connection* {
+        switch (reference.kind) {
+            case ConnectionKind::HUB: return hubs[reference.index].get();
+            case ConnectionKind::SINK: return sinks[reference.index].get();
+            default: return nullptr;
+        }
+    };
+    for (int i = 0; i < (int)simulations.size(); ++i) {
+        const PipeDescription& pipe = description.pipes[i];
+        if (pipe.left.kind != ConnectionKind::NONE) {
+            simulations[i]->setLeftConnection(connectionOf(pipe.left));
+        }
+        if (pipe.right.kind != ConnectionKind::NONE) {
+            simulations[i]->setRightConnection(connectionOf(pipe.right));
         }
     }
-    
+
+    // The alias tables are built here rather than stored, from the weights and flows above, in linear time
+    for (auto& hub : hubs) {
+        hub->initializeProbabilities();
+    }
+
     // ------------------------------------------------------------------------
-    // 7) Parse "emitters" for each pipe, if present
+    // 3) Receivers and emitters
     // ------------------------------------------------------------------------
-    for (auto& kv : simulations) {
-        const std::string& pipeName = kv.first;
-        Simulation* simPtr = kv.second.get();
-
-        // Look up the original YAML node
-        const auto& pipeCfg = pipeNodes[pipeName];
-        
-        // MODIFICATION: Check if emitters are present in the pipe configuration
-        if (!pipeCfg["emitters"] || !pipeCfg["emitters"].IsSequence()) {
-            // no emitters for this pipe
-            continue;
-        }
-
-        // For each emitter definition
-        for (auto& emitterCfg : pipeCfg["emitters"]) {
-            // MODIFICATION: Parse emitter coordinates from cylindrical to cartesian
-            double z = emitterCfg["z"] ? emitterCfg["z"].as<double>() : 0.0;
-            double rCyl = emitterCfg["r"] ? emitterCfg["r"].as<double>() : 0.0;
-            double theta = emitterCfg["theta"] ? emitterCfg["theta"].as<double>() : 0.0;
-
-            // Convert from cylindrical -> cartesian
-            glm::dvec3 cylPos(rCyl, theta, z);
-            glm::dvec3 cartPos = cylindricalToCartesian(cylPos);
-
-            // MODIFICATION: Parse emitter pattern
-            std::vector<int> emissionPattern;
-            if (emitterCfg["emitter_pattern"]) {
-                std::string patternStr = emitterCfg["emitter_pattern"].as<std::string>();
-                std::stringstream ss(patternStr);
-                std::string item;
-                
-                // Parse comma-separated values into integer vector
-                while (std::getline(ss, item, ',')) {
-                    try {
-                        emissionPattern.push_back(std::stoi(item));
-                    } catch (const std::exception& e) {
-                        std::cerr << "[Warning] Invalid emitter pattern value: " << item
-                                  << " in pipe: " << pipeName << ". Skipping.\n";
-                    }
-                }
+    for (int i = 0; i < (int)simulations.size(); ++i) {
+        Simulation* simPtr = simulations[i].get();
+        const PipeDescription& pipe = description.pipes[i];
+
+        for (const auto& rcv : pipe.receivers) {
+            std::unique_ptr<Receiver> receiver;
+            switch (rcv.kind) {
+                case ReceiverKind::SPHERE:
+                    receiver = std::make_unique<SphericalReceiver>(rcv.position, rcv.countingType, rcv.radius);
+                    break;
+                case ReceiverKind::RING:
+                    receiver = std::make_unique<RingReceiver>(rcv.position, rcv.countingType, rcv.orientation);
+                    break;
+                case ReceiverKind::RING_WITH_THICKNESS:
+                    receiver = std::make_unique<RingReceiverWithThickness>(rcv.position, rcv.countingType, rcv.orientation, rcv.thickness);
+                    break;
+                case ReceiverKind::TRAP:
+                    receiver = std::make_unique<TrapReceiver>(rcv.position, rcv.countingType, rcv.radius, rcv.length, rcv.theta, rcv.deltaTheta, rcv.thickness);
+                    break;
             }
-
-            // Get the pattern type (defaults to "repeat" if not specified)
-            std::string patternType = "repeat";
-            if (emitterCfg["emitter_pattern_type"]) {
-                patternType = emitterCfg["emitter_pattern_type"].as<std::string>();
-                // Validate pattern type
-                if (patternType != "repeat" && patternType != "complete") {
-                    std::cerr << "[Warning] Invalid emitter pattern type: " << patternType
-                               << " in pipe: " << pipeName << ". Defaulting to 'repeat'.\n";
-                    patternType = "repeat";
-                }
+            if (!rcv.name.empty()) {
+                receiver->setName(rcv.name);
             }
+            simPtr->addReceiver(std::move(receiver));
+        }
 
-            // MODIFICATION: Create and add emitter to simulation
-            if (!emissionPattern.empty()) {
-                auto emitter = std::make_unique<Emitter>(
-                    cartPos,           // position
-                    emissionPattern,   // emission pattern
-                    simPtr,            // pointer to simulation
-                    patternType        // pattern type
-                );
-
-                simPtr->addEmitter(std::move(emitter));
-            } else {
-                std::cerr << "[Warning] Emitter in pipe: " << pipeName
-                          << " has no valid emission pattern. Skipping.\n";
+        for (int k = 0; k < (int)pipe.emitters.size(); ++k) {
+            const EmitterDescription& emitter = pipe.emitters[k];
+            EmissionSchedule schedule;
+            switch (emitter.kind) {
+                case EmissionKind::PATTERN:
+                    schedule = EmissionSchedule::pattern(emitter.pattern, emitter.patternType != "complete");
+                    break;
+                case EmissionKind::POISSON:
+                    schedule = EmissionSchedule::poisson(emitter.rate, emitter.start, emitter.stop, parameters.dt,
+                                                         RandomStream(seed, streamIdFromName(pipe.name + ":emitter" + std::to_string(k))));
+                    break;
+                case EmissionKind::PULSE_TRAIN:
+                    // An unlimited train with several pulses per iteration would release ever more particles at
+                    // once, without bound, as its pulses pile up
+                    if (emitter.pulses == 0 && emitter.period < parameters.dt) {
+                        throw std::runtime_error(pipe.name + ": a pulse_train emitter without pulses needs a period of at least dt ("
+                                                 + std::to_string(parameters.dt) + " s)");
+                    }
+                    schedule = EmissionSchedule::pulseTrain(emitter.count, emitter.start, emitter.period, emitter.pulses, parameters.dt);
+                    break;
             }
+            simPtr->addEmitter(std::make_unique<Emitter>(emitter.position, std::move(schedule), simPtr));
         }
     }
 
     // ------------------------------------------------------------------------
-    // 8) Move all Simulations into the SimulationNetwork
+    // 4) Move everything into the SimulationNetwork
     // ------------------------------------------------------------------------
-    for (auto& simKV : simulations) {
-        network->addSimulation(std::move(simKV.second));
+    for (auto& sim : simulations) {
+        network->addSimulation(std::move(sim));
     }
-
-    // If your SimulationNetwork also needs to store the hubs, do that here:
-    // e.g.
-    for (auto& hub : allHubs) {
-     network->addHub(std::move(hub));
+    for (auto& hub : hubs) {
+        network->addHub(std::move(hub));
     }
-    
-    // Add all sinks to the SimulationNetwork
-    for (auto& sinkKV : sinks) {
-        network->addSink(std::move(sinkKV.second));
+    for (auto& sink : sinks) {
+        network->addSink(std::move(sink));
     }
 
     return network;
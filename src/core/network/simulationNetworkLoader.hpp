@@ -10,6 +10,10 @@
 
 #include <memory>
 #include <string>
+#include <optional>
+#include <cstdint>
+#include <src/config/simulationParameters.hpp>
+#include <src/core/network/networkDescription.hpp>
 
 // Forward declare classes to avoid including everything here.
 class SimulationNetwork;
@@ -20,7 +24,28 @@ public:
     // Load from a YAML file and build a SimulationNetwork object.
     // On success, returns a unique_ptr to the newly constructed SimulationNetwork.
     // Throws on failure (file not found, malformed YAML, etc.).
-    static std::unique_ptr<SimulationNetwork> loadFromYAML(const std::string& filename);
+    // defaultSeed is used when the file has no seed of its own.
+    // The simulation parameters start from the config.h defaults, then the file's simulation: section,
+    // then overrides (the command line).
+    // With NETWORK_CACHE the resolved network is kept in a compiled network next to the file
+    // (see src/core/network/compiledNetwork.hpp) and the YAML is only read again when it changes.
+    static std::unique_ptr<SimulationNetwork> loadFromYAML(const std::string& filename,
+                                                           std::optional<uint64_t> defaultSeed = std::nullopt,
+                                                           const SimulationParameterOverrides& overrides = SimulationParameterOverrides());
+
+    // The description loadFromYAML builds its network from: the compiled network when it is current, else the YAML.
+    // writeCache false only reuses a current compiled network and never writes one (bulk runs: one-off configs,
+    // possibly in a read-only directory).
+    static NetworkDescription loadDescription(const std::string& filename, bool writeCache = true);
+
+    // Reads a YAML file and resolves it: connections, hubs and flows. Throws like loadFromYAML.
+    static NetworkDescription describeYAML(const std::string& filename);
+
+    // Builds the network a description stands for. sourceName is only used in messages.
+    static std::unique_ptr<SimulationNetwork> buildNetwork(const NetworkDescription& description,
+                                                           const std::string& sourceName,
+                                                           std::optional<uint64_t> defaultSeed = std::nullopt,
+                                                           const SimulationParameterOverrides& overrides = SimulationParameterOverrides());
 };
 
 #endif /* networkLoader_hpp */
@@ -0,0 +1,222 @@
+//
+//  streamingYamlReader.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "streamingYamlReader.hpp"
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+// Values inside a container are written straight into a new element of it ("slot"), in the container's own
+// node memory. Building them as nodes of their own and inserting them would merge memory for every scalar,
+// which costs more than parsing.
+
+StreamingYamlReader::StreamingYamlReader(std::vector<std::string> streamedSections, EntryCallback onEntry)
+    : streamedSections(std::move(streamedSections)), onEntry(std::move(onEntry))
+{
+}
+
+void StreamingYamlReader::readFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open network config " + filename);
+    }
+    
+    // Only the first document is read, as YAML::LoadFile does
+    YAML::Parser parser(file);
+    parser.HandleNextDocument(*this);
+}
+
+bool StreamingYamlReader::isStreamed(const std::string& key) const
+{
+    return std::find(streamedSections.begin(), streamedSections.end(), key) != streamedSections.end();
+}
+
+void StreamingYamlReader::rememberAnchor(const YAML::Node& node, YAML::anchor_t anchor)
+{
+    if (anchor != YAML::NullAnchor) {
+        anchors[anchor].reset(node);
+    }
+}
+
+// The element of the container being built that the value starting now goes into.
+// Nothing at the top level and for map keys, those are passed to complete() as nodes of their own.
+std::optional<YAML::Node> StreamingYamlReader::takeSlot()
+{
+    if (stack.empty()) {
+        return std::nullopt;
+    }
+    Frame& parent = stack.back();
+    if (parent.isSequence) {
+        return parent.node[parent.count++];
+    }
+    if (!parent.hasKey) {
+        return std::nullopt;
+    }
+    parent.hasKey = false;
+    if (parent.hasNodeKey) {
+        YAML::Node slot(YAML::NodeType::Null);
+        parent.node.force_insert(parent.nodeKey, slot);
+        parent.hasNodeKey = false;
+        return slot;
+    }
+    return parent.node[parent.scalarKey];
+}
+
+void StreamingYamlReader::openContainer(YAML::NodeType::value type, YAML::anchor_t anchor)
+{
+    std::optional<YAML::Node> slot = takeSlot();
+    
+    Frame frame;
+    frame.node.reset(slot ? *slot : YAML::Node(type));
+    frame.anchor = anchor;
+    frame.isSequence = (type == YAML::NodeType::Sequence);
+    frame.inParent = slot.has_value();
+    stack.push_back(std::move(frame));
+}
+
+void StreamingYamlReader::closeContainer()
+{
+    Frame frame = std::move(stack.back());
+    stack.pop_back();
+    
+    if (!frame.inParent) {
+        complete(frame.node, frame.anchor, YAML::Mark::null_mark());
+        return;
+    }
+    // A slot only takes its type from its first element
+    if (!frame.node.IsDefined() || frame.node.IsNull()) {
+        frame.node = YAML::Node(frame.isSequence ? YAML::NodeType::Sequence : YAML::NodeType::Map);
+    }
+    rememberAnchor(frame.node, frame.anchor);
+}
+
+// A whole node that is not in a slot has been read: a map key, a top-level value or a streamed entry
+void StreamingYamlReader::complete(const YAML::Node& node, YAML::anchor_t anchor, const YAML::Mark& mark)
+{
+    rememberAnchor(node, anchor);
+    
+    if (!stack.empty()) {
+        Frame& parent = stack.back();
+        parent.hasKey = true;
+        parent.hasNodeKey = !node.IsScalar();
+        if (parent.hasNodeKey) {
+            parent.nodeKey.reset(node);
+        } else {
+            parent.scalarKey = node.Scalar();
+        }
+        return;
+    }
+    
+    if (streaming) {
+        if (!hasEntryKey) {
+            entryKey = node.Scalar();
+            entryMark = mark;
+            hasEntryKey = true;
+            return;
+        }
+        hasEntryKey = false;
+        try {
+            onEntry(topKey, entryKey, node);
+        } catch (const std::exception& e) {
+            throw std::runtime_error(topKey + ": " + entryKey + " (line " + std::to_string(entryMark.line + 1) + "): " + e.what());
+        }
+        return;
+    }
+    
+    // A document that is not a map has no keys to give
+    if (!inRoot) {
+        return;
+    }
+    if (!hasTopKey) {
+        topKey = node.Scalar();
+        hasTopKey = true;
+    } else {
+        topLevel[topKey] = node;
+        hasTopKey = false;
+    }
+}
+
+void StreamingYamlReader::OnDocumentStart(const YAML::Mark&)
+{
+}
+
+void StreamingYamlReader::OnDocumentEnd()
+{
+}
+
+void StreamingYamlReader::OnNull(const YAML::Mark& mark, YAML::anchor_t anchor)
+{
+    std::optional<YAML::Node> slot = takeSlot();
+    if (slot) {
+        *slot = YAML::Null;
+        rememberAnchor(*slot, anchor);
+        return;
+    }
+    complete(YAML::Node(YAML::NodeType::Null), anchor, mark);
+}
+
+void StreamingYamlReader::OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor)
+{
+    auto it = anchors.find(anchor);
+    if (it == anchors.end()) {
+        throw YAML::ParserException(mark, "alias to an anchor that is not available (anchors on streamed sections are not kept)");
+    }
+    std::optional<YAML::Node> slot = takeSlot();
+    if (slot) {
+        *slot = it->second;
+        return;
+    }
+    complete(it->second, YAML::NullAnchor, mark);
+}
+
+void StreamingYamlReader::OnScalar(const YAML::Mark& mark, const std::string&, YAML::anchor_t anchor, const std::string& value)
+{
+    std::optional<YAML::Node> slot = takeSlot();
+    if (slot) {
+        *slot = value;
+        rememberAnchor(*slot, anchor);
+        return;
+    }
+    complete(YAML::Node(value), anchor, mark);
+}
+
+void StreamingYamlReader::OnSequenceStart(const YAML::Mark&, const std::string&, YAML::anchor_t anchor, YAML::EmitterStyle::value)
+{
+    openContainer(YAML::NodeType::Sequence, anchor);
+}
+
+void StreamingYamlReader::OnSequenceEnd()
+{
+    closeContainer();
+}
+
+void StreamingYamlReader::OnMapStart(const YAML::Mark&, const std::string&, YAML::anchor_t anchor, YAML::EmitterStyle::value)
+{
+    if (stack.empty() && !inRoot && !streaming) {
+        inRoot = true;
+        return;
+    }
+    if (stack.empty() && inRoot && !streaming && hasTopKey && isStreamed(topKey)) {
+        streaming = true;
+        hasEntryKey = false;
+        return;
+    }
+    openContainer(YAML::NodeType::Map, anchor);
+}
+
+void StreamingYamlReader::OnMapEnd()
+{
+    if (!stack.empty()) {
+        closeContainer();
+    } else if (streaming) {
+        streaming = false;
+        hasTopKey = false;
+    } else {
+        inRoot = false;
+    }
+}
@@ -0,0 +1,90 @@
+//
+//  streamingYamlReader.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef streamingYamlReader_hpp
+#define streamingYamlReader_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <optional>
+#include <yaml-cpp/yaml.h>
+#include <yaml-cpp/eventhandler.h>
+
+// Reads a YAML document from the parser's events instead of loading the whole tree.
+// The entries of the top-level maps named as streamed sections ("pipes:") are built one at a time, handed to
+// the callback and dropped, so however many there are only one is in memory at a time.
+// Every other top-level key is kept whole and can be looked at once the file is read.
+// Anchors and aliases work, anchored nodes are kept until the end of the document.
+class StreamingYamlReader : public YAML::EventHandler
+{
+public:
+    using EntryCallback = std::function<void(const std::string& section, const std::string& key, const YAML::Node& value)>;
+
+private:
+    struct Frame {
+        YAML::Node node;
+        YAML::anchor_t anchor;
+        bool isSequence;
+        bool inParent; // node is already an element of the frame below
+        size_t count = 0; // sequences: elements so far
+        bool hasKey = false; // maps: the key of the next value has been read
+        bool hasNodeKey = false; // the key is not a scalar
+        std::string scalarKey;
+        YAML::Node nodeKey;
+    };
+
+    std::vector<std::string> streamedSections;
+    EntryCallback onEntry;
+
+    std::vector<Frame> stack; // containers being built
+    std::unordered_map<YAML::anchor_t, YAML::Node> anchors;
+    YAML::Node topLevel = YAML::Node(YAML::NodeType::Map);
+
+    bool inRoot = false; // inside the document's top-level map
+    bool hasTopKey = false;
+    std::string topKey;
+    bool streaming = false; // inside one of the streamed sections
+    bool hasEntryKey = false;
+    std::string entryKey;
+    YAML::Mark entryMark;
+
+    std::optional<YAML::Node> takeSlot();
+    void openContainer(YAML::NodeType::value type, YAML::anchor_t anchor);
+    void closeContainer();
+    void complete(const YAML::Node& node, YAML::anchor_t anchor, const YAML::Mark& mark);
+    void rememberAnchor(const YAML::Node& node, YAML::anchor_t anchor);
+    bool isStreamed(const std::string& key) const;
+
+public:
+    StreamingYamlReader(std::vector<std::string> streamedSections, EntryCallback onEntry);
+
+    // Throws std::runtime_error if the file cannot be opened, YAML::ParserException if it is malformed.
+    // What the callback throws comes out as a std::runtime_error naming the entry and its line.
+    void readFile(const std::string& filename);
+
+    // The top-level keys that were not streamed
+    const YAML::Node& getTopLevel() const;
+
+    void OnDocumentStart(const YAML::Mark& mark) override;
+    void OnDocumentEnd() override;
+    void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override;
+    void OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override;
+    void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, const std::string& value) override;
+    void OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override;
+    void OnSequenceEnd() override;
+    void OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override;
+    void OnMapEnd() override;
+};
+
+inline const YAML::Node& StreamingYamlReader::getTopLevel() const {
+    return topLevel;
+}
+
+#endif /* streamingYamlReader_hpp */
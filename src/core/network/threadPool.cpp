@@ -0,0 +1,121 @@
+//
+//  threadPool.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "threadPool.hpp"
+
+ThreadPool::ThreadPool(int threadCount)
+{
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (threadCount <= 0) {
+            threadCount = 1;
+        }
+    }
+
+    workers.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop(int threadIndex)
+{
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+        }
+
+        runJob(threadIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            workersDone++;
+            if (workersDone == workers.size()) {
+                doneCondition.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::runJob(int threadIndex)
+{
+    try {
+        (*job)(threadIndex);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!firstError) {
+            firstError = std::current_exception();
+        }
+    }
+}
+
+void ThreadPool::runOnEachThread(const std::function<void(int)>& function)
+{
+    if (workers.empty()) {
+        function(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &function;
+        workersDone = 0;
+        firstError = nullptr;
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    runJob(0);
+
+    // Wait for every worker before returning: the job lives on the caller's stack
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [&] { return workersDone == workers.size(); });
+        error = firstError;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& function)
+{
+    if (workers.empty() || count <= 1) {
+        for (int i = 0; i < count; ++i) {
+            function(i);
+        }
+        return;
+    }
+
+    std::atomic<int> nextIndex(0);
+    runOnEachThread([&](int) {
+        int index;
+        while ((index = nextIndex.fetch_add(1)) < count) {
+            function(index);
+        }
+    });
+}
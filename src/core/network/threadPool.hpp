@@ -0,0 +1,60 @@
+//
+//  threadPool.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef threadPool_hpp
+#define threadPool_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <cstdint>
+
+// Fixed set of worker threads that run one job at a time.
+// The threads are kept alive between calls, so the per-iteration cost is a wake-up, not a thread start.
+// The calling thread takes part in the work too, so a pool of N threads has N - 1 workers.
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    const std::function<void(int)>* job = nullptr;
+    uint64_t generation = 0; // bumped for every job, workers run each generation exactly once
+    size_t workersDone = 0;
+    bool stopping = false;
+    std::exception_ptr firstError;
+
+    void workerLoop(int threadIndex);
+    void runJob(int threadIndex);
+
+public:
+    // threadCount <= 0 means one thread per hardware thread
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    int getThreadCount() const;
+
+    // Calls function(threadIndex) once on every thread of the pool, the calling thread being index 0,
+    // and returns when all calls are done. The first exception thrown by a call is rethrown here.
+    void runOnEachThread(const std::function<void(int)>& function);
+    
+    // Calls function(i) for every i in [0, count) across the pool and returns when all calls are done.
+    void parallelFor(int count, const std::function<void(int)>& function);
+};
+
+inline int ThreadPool::getThreadCount() const {
+    return static_cast<int>(workers.size()) + 1;
+}
+
+#endif /* threadPool_hpp */
@@ -0,0 +1,67 @@
+//
+//  workStealingScheduler.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "workStealingScheduler.hpp"
+
+WorkStealingScheduler::WorkStealingScheduler(ThreadPool& pool)
+    : pool(pool), queues(new TaskQueue[pool.getThreadCount()]), queueCount(pool.getThreadCount())
+{}
+
+bool WorkStealingScheduler::popOwn(int threadIndex, int& task)
+{
+    TaskQueue& queue = queues[threadIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.head == queue.tail) {
+        return false;
+    }
+    task = queue.head++;
+    return true;
+}
+
+bool WorkStealingScheduler::steal(int threadIndex, int& task)
+{
+    // Victims are tried in a fixed rotation starting after the thief, so thieves spread over the victims
+    for (int offset = 1; offset < queueCount; ++offset) {
+        TaskQueue& victim = queues[(threadIndex + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.head != victim.tail) {
+            task = --victim.tail;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingScheduler::run(const std::vector<double>& costs, const std::function<void(int)>& function)
+{
+    int taskCount = static_cast<int>(costs.size());
+    
+    double totalCost = 0.0;
+    for (double cost : costs) {
+        totalCost += cost;
+    }
+    
+    // Cut the task list where the running cost crosses each thread's share
+    int task = 0;
+    double runningCost = 0.0;
+    for (int t = 0; t < queueCount; ++t) {
+        double shareEnd = totalCost * (t + 1) / queueCount;
+        queues[t].head = task;
+        while (task < taskCount && (t == queueCount - 1 || runningCost + costs[task] * 0.5 <= shareEnd)) {
+            runningCost += costs[task];
+            task++;
+        }
+        queues[t].tail = task;
+    }
+    
+    pool.runOnEachThread([&](int threadIndex) {
+        int current;
+        while (popOwn(threadIndex, current) || steal(threadIndex, current)) {
+            function(current);
+        }
+    });
+}
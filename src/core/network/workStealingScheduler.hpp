@@ -0,0 +1,47 @@
+//
+//  workStealingScheduler.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef workStealingScheduler_hpp
+#define workStealingScheduler_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <src/core/network/threadPool.hpp>
+
+// Runs a list of tasks with uneven, roughly known costs on a thread pool.
+// The tasks are dealt to the threads in contiguous runs of about the same total cost, so neighbouring
+// tasks (blocks of the same pipe) stay on the same thread. Every thread works through its own run from the
+// front, and once it is empty steals single tasks from the back of the other threads' runs, so a wrong
+// cost estimate only costs a few steals instead of an idle thread.
+class WorkStealingScheduler
+{
+private:
+    // The part of the task list a thread still has to run, [head, tail)
+    struct alignas(64) TaskQueue {
+        std::mutex mutex;
+        int head = 0;
+        int tail = 0;
+    };
+
+    ThreadPool& pool;
+    std::unique_ptr<TaskQueue[]> queues;
+    int queueCount;
+
+    bool popOwn(int threadIndex, int& task);
+    bool steal(int threadIndex, int& task);
+
+public:
+    explicit WorkStealingScheduler(ThreadPool& pool);
+
+    // Calls function(task) for every task in [0, costs.size()) and returns when all calls are done
+    void run(const std::vector<double>& costs, const std::function<void(int)>& function);
+};
+
+#endif /* workStealingScheduler_hpp */
@@ -18,22 +18,19 @@
 #include <src/core/boundaries/noBoundary.hpp>
 #include <src/core/boundaries/boundary.hpp>
 
-class Simulation;
-
+// Simulations keep their particles in a ParticleStore (see particleStore.hpp).
+// Particle is only the value passed around at hand-offs between connections.
+// The boundary and simulation a particle belongs to are the same for every particle of a pipe,
+// so they are kept on the Simulation instead of on every particle.
 class Particle
 {
 private:
     glm::dvec3 position;
     bool alive;
-    Boundary* associatedBoundary;
-    Simulation* associatedSimulation;
     
 public:
     Particle(double x, double y, double z);
-    void move(double dx, double dy, double dz, bool* toBeKilled);
     const glm::dvec3& getPosition() const;
-    void setBoundary(Boundary* boundary);
-    void setSimulation(Simulation* simulation);
     void kill();
     void revive();
     bool isAlive() const;
@@ -44,16 +41,6 @@ inline const glm::dvec3& Particle::getPosition() const
     return position;
 }
 
-inline void Particle::setBoundary(Boundary* boundary)
-{
-    associatedBoundary = boundary;
-}
-
-inline void Particle::setSimulation(Simulation *simulation)
-{
-    associatedSimulation = simulation;
-}
-
 inline void Particle::kill()
 {
     alive = false;
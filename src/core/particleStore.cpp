@@ -0,0 +1,51 @@
+//
+//  particleStore.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "particleStore.hpp"
+#include <algorithm>
+
+ParticleStore::ParticleStore() {}
+
+void ParticleStore::reserve(int capacity) {
+    xs.reserve(capacity);
+    ys.reserve(capacity);
+    zs.reserve(capacity);
+    wakes.reserve(capacity);
+}
+
+int ParticleStore::add(double x, double y, double z) {
+    xs.push_back(x);
+    ys.push_back(y);
+    zs.push_back(z);
+    wakes.push_back(0);
+    return size() - 1;
+}
+
+int ParticleStore::grow(int count) {
+    int first = size();
+    if (first + count > capacity()) {
+        // Grow geometrically like push_back, so a burst followed by single adds does not copy the store again
+        reserve(std::max(first + count, 2 * capacity()));
+    }
+    xs.resize(first + count);
+    ys.resize(first + count);
+    zs.resize(first + count);
+    wakes.resize(first + count, 0);
+    return first;
+}
+
+void ParticleStore::remove(int index) {
+    int last = size() - 1;
+    xs[index] = xs[last];
+    ys[index] = ys[last];
+    zs[index] = zs[last];
+    wakes[index] = wakes[last];
+    xs.pop_back();
+    ys.pop_back();
+    zs.pop_back();
+    wakes.pop_back();
+}
@@ -6,24 +6,97 @@
 //
 
 #include "receiver.hpp"
+#include <src/output/receiverOutput.hpp>
+#include <fstream>
+#include <map>
+#include <iomanip>
 
 Receiver::Receiver(glm::dvec3 position, int countingType) : position(position), countingType(countingType), name(""), totalReceived(0) {
-    particlesReceived = new int[NUMBER_OF_ITERATIONS]();
+    binIterations = RECEIVER_BIN_ITERATIONS;
+    binCount = 0;
+    dt = DT;
+    particlesReceived = nullptr;
+}
+
+void Receiver::setTimeWindow(int iterationCount, double dt, int binIterations) {
+    this->dt = dt;
+    this->binIterations = binIterations;
+    binCount = (iterationCount + binIterations - 1) / binIterations;
+    
+    delete[] particlesReceived;
+    particlesReceived = RECEIVER_SPARSE_COUNTS ? nullptr : new int[binCount]();
+    eventBins.clear();
+    eventCounts.clear();
+    expectedCounts.clear();
 }
 
 Receiver::~Receiver() {
     delete[] particlesReceived;
 }
 
-void Receiver::writeOutput(const std::string& dirPath, const std::string& pipeName, bool isSphericalReceiver, double radius) {
+void Receiver::collectNonZeroBins(std::vector<uint64_t>& bins, std::vector<uint64_t>& counts) const {
+    bins.clear();
+    counts.clear();
+    
+    if (particlesReceived) {
+        for (int i = 0; i < binCount; ++i) {
+            if (particlesReceived[i] != 0) {
+                bins.push_back(i);
+                counts.push_back(particlesReceived[i]);
+            }
+        }
+        return;
+    }
+    
+    // Iterations normally arrive in order, so the events are already sorted and merged
+    bool sorted = true;
+    for (size_t i = 1; i < eventBins.size(); ++i) {
+        if (eventBins[i] <= eventBins[i - 1]) {
+            sorted = false;
+            break;
+        }
+    }
+    if (sorted) {
+        bins.assign(eventBins.begin(), eventBins.end());
+        counts.assign(eventCounts.begin(), eventCounts.end());
+        return;
+    }
+    
+    std::map<int, uint64_t> merged;
+    for (size_t i = 0; i < eventBins.size(); ++i) {
+        merged[eventBins[i]] += eventCounts[i];
+    }
+    for (const auto& entry : merged) {
+        bins.push_back(entry.first);
+        counts.push_back(entry.second);
+    }
+}
 
-    // Create the output string with just comma-separated numbers
-    std::string output;
+void Receiver::writeOutput(const std::string& dirPath, const std::string& pipeName, bool isSphericalReceiver, double radius) {
 
     glm::dvec3 car = cartesianToCylindrical(position);
+    std::string baseName = dirPath + "/" + (name.empty() ? "unnamed_receiver" : name);
+    
+    ReceiverOutput counts;
+    collectNonZeroBins(counts.bins, counts.counts);
+    
+    // .rcv files hold whole counts, so expected counts always go to .txt
+    if (RECEIVER_OUTPUT_BINARY && expectedCounts.empty()) {
+        ReceiverOutputHeader& header = counts.header;
+        header.pipeName = pipeName;
+        header.receiverName = name;
+        header.r = car.x;
+        header.z = car.z;
+        header.hasRadius = isSphericalReceiver;
+        header.radius = isSphericalReceiver ? radius : 0.0;
+        header.dt = dt * binIterations;
+        header.binCount = binCount;
+        writeReceiverOutputBinary(baseName + ".rcv", counts);
+        return;
+    }
 
     // Add pipe name, r, z coordinates and radius of the receiver (I am assuming all receivers are sphericalReceiver for now)
-    output = pipeName + " " + std::to_string(car.x) + " " + std::to_string(car.z);
+    std::string output = pipeName + " " + std::to_string(car.x) + " " + std::to_string(car.z);
 
     // Checking if the receiver is of type sphericalReceiver, if so add radius
     // this is a very shitty implementation. i am only doing this for now because i will only work with spherical receivers but in the future i might need to make every receiver type have its own write function.
@@ -31,18 +104,39 @@ void Receiver::writeOutput(const std::string& dirPath, const std::string& pipeNa
         output += " " + std::to_string(radius);
     }
     
-    output += "\n";
-
-    for (int i = 0; i < NUMBER_OF_ITERATIONS; ++i) {
-        output += std::to_string(particlesReceived[i]);
-        if (i != NUMBER_OF_ITERATIONS - 1) {
-            output += ",";
-        }
-    }
-    
     // Use the receiver's name as the filename
-    std::string filename = dirPath + "/" + (name.empty() ? "unnamed_receiver" : name) + ".txt";
+    std::ofstream outFile(baseName + ".txt"); // overwrite mode
+    if (!outFile) {
+        std::cerr << "Error: Could not open file " << baseName << ".txt for writing." << std::endl;
+        return;
+    }
     
-    // Write to file (overwrite mode)
-    writeToFile(filename, output, false);
+    // The comma-separated counts are streamed to the file instead of being built up in one string
+    outFile << output << "\n";
+    if (!expectedCounts.empty()) {
+        outFile << std::setprecision(9);
+        for (int i = 0; i < binCount; ++i) {
+            outFile << expectedCounts[i] << (i != binCount - 1 ? "," : "");
+        }
+        outFile << std::endl;
+        return;
+    }
+    size_t nextEvent = 0;
+    for (int i = 0; i < binCount; ++i) {
+        if (nextEvent < counts.bins.size() && counts.bins[nextEvent] == static_cast<uint64_t>(i)) {
+            outFile << counts.counts[nextEvent++];
+        } else {
+            outFile << '0';
+        }
+        if (i != binCount - 1) {
+            outFile << ',';
+        }
+    }
+    outFile << std::endl;
+}
+
+void Receiver::hitBatch(const double* x, const double* y, const double* z, int count, uint8_t* mask) const {
+    for (int i = 0; i < count; ++i) {
+        mask[i] = hit(glm::dvec3(x[i], y[i], z[i])) ? 1 : 0;
+    }
 }
@@ -11,6 +11,10 @@
 #include <stdio.h>
 #include <glm/vec3.hpp>
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
 #include <src/config/config.h>
 #include <src/config/unused/oldconfig.h>
 #include <src/output/writer.hpp>
@@ -19,7 +23,16 @@
 class Receiver {
 protected:
     glm::dvec3 position;
-    int* particlesReceived;
+    int binIterations; // iterations per output bin
+    int binCount; // 0 until setTimeWindow
+    double dt; // seconds per iteration
+    int* particlesReceived; // count of every bin, nullptr when counting sparsely
+    // Sparse counting: the bins that got hits, in the order they got them, and their counts.
+    // Hits are rare, so this is a few entries where the dense array is a bin for every iteration.
+    std::vector<int> eventBins;
+    std::vector<int> eventCounts;
+    // Expected counts of every bin, for receivers filled by impulse-response synthesis instead of a run
+    std::vector<double> expectedCounts;
     std::string name;
     int totalReceived; // Total number of particles received
     int countingType; // 0 for absorbing 1 for observing;
@@ -34,7 +47,15 @@ public:
 
     glm::dvec3 getPosition() const;
     int getCountingType() const;
+    // Sizes the counts for a run of iterationCount iterations of dt seconds, done when the receiver is added to a simulation.
+    // Impulse-response measurements count every iteration on its own, whatever RECEIVER_BIN_ITERATIONS is.
+    void setTimeWindow(int iterationCount, double dt, int binIterations = RECEIVER_BIN_ITERATIONS);
     void increaseParticlesReceived(int iterationNumber);
+    void increaseParticlesReceived(int iterationNumber, int count);
+    // Adds a fractional expected count instead of hits; writeOutput then writes the expected counts, as .txt
+    void addExpectedParticlesReceived(int iterationNumber, double count);
+    // The non-zero bins in increasing order, from either form of counting
+    void collectNonZeroBins(std::vector<uint64_t>& bins, std::vector<uint64_t>& counts) const;
     void writeOutput(const std::string& path, const std::string& pipeName, bool isSphericalReceiver, double radius);
     
     // Name getter and setter
@@ -46,6 +67,16 @@ public:
     
     // Pure virtual function for interaction detection
     virtual bool hit(glm::dvec3 particlePosition) const = 0;
+    // z range outside of which hit() is always false, used to index the receivers of a pipe (see ReceiverIndex).
+    // The default is unbounded.
+    virtual void getAxialExtent(double& zMin, double& zMax) const;
+    // Lower bound on the distance from a point to anywhere hit() is true, 0 when the point may be inside.
+    // The default is the distance along z to the axial extent.
+    virtual double clearance(glm::dvec3 point) const;
+    // Tests count particles at once, given as coordinate arrays: mask[i] is set to 1 if hit() would be true
+    // for particle i and to 0 otherwise. The receiver types override it with a plain loop over their own test,
+    // so a block of particles costs one virtual call instead of one per particle.
+    virtual void hitBatch(const double* x, const double* y, const double* z, int count, uint8_t* mask) const;
 };
 
 inline glm::dvec3 Receiver::getPosition() const {
@@ -56,9 +87,48 @@ inline int Receiver::getCountingType() const {
     return countingType;
 }
 
+inline void Receiver::getAxialExtent(double& zMin, double& zMax) const {
+    zMin = -std::numeric_limits<double>::infinity();
+    zMax = std::numeric_limits<double>::infinity();
+}
+
+inline double Receiver::clearance(glm::dvec3 point) const {
+    double zMin, zMax;
+    getAxialExtent(zMin, zMax);
+    return std::max(std::max(zMin - point.z, point.z - zMax), 0.0);
+}
+
 inline void Receiver::increaseParticlesReceived(int iterationNumber) {
-    particlesReceived[iterationNumber]++;
-    totalReceived++;
+    increaseParticlesReceived(iterationNumber, 1);
+}
+
+inline void Receiver::increaseParticlesReceived(int iterationNumber, int count) {
+    totalReceived += count;
+    
+    int bin = iterationNumber / binIterations;
+    if (bin >= binCount) {
+        return; // past the recorded time window
+    }
+    
+    if (particlesReceived) {
+        particlesReceived[bin] += count;
+    } else if (!eventBins.empty() && eventBins.back() == bin) {
+        eventCounts.back() += count;
+    } else {
+        eventBins.push_back(bin);
+        eventCounts.push_back(count);
+    }
+}
+
+inline void Receiver::addExpectedParticlesReceived(int iterationNumber, double count) {
+    int bin = iterationNumber / binIterations;
+    if (bin >= binCount) {
+        return; // past the recorded time window
+    }
+    if (expectedCounts.empty()) {
+        expectedCounts.assign(binCount, 0.0);
+    }
+    expectedCounts[bin] += count;
 }
 
 inline std::string Receiver::getName() const {
@@ -0,0 +1,129 @@
+//
+//  receiverIndex.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "receiverIndex.hpp"
+#include <cmath>
+
+namespace {
+
+// Slabs made per receiver: narrow enough that most slabs hold one or two receivers
+const int SLABS_PER_RECEIVER = 4;
+const int MAX_SLABS = 4096;
+
+} // end anonymous namespace
+
+void ReceiverIndex::build(const std::vector<std::unique_ptr<Receiver>>& receivers, double zMin, double zMax)
+{
+    slabStart.clear();
+    slabReceivers.clear();
+    indexed.clear();
+    for (const auto& receiver : receivers) {
+        indexed.push_back(receiver.get());
+    }
+    
+    // Merge the extents for axialClearance
+    std::vector<std::pair<double, double>> extents(receivers.size());
+    for (int k = 0; k < receivers.size(); ++k) {
+        receivers[k]->getAxialExtent(extents[k].first, extents[k].second);
+    }
+    std::sort(extents.begin(), extents.end());
+    coveredStart.clear();
+    coveredEnd.clear();
+    for (const auto& extent : extents) {
+        if (!coveredEnd.empty() && extent.first <= coveredEnd.back()) {
+            coveredEnd.back() = std::max(coveredEnd.back(), extent.second);
+        } else {
+            coveredStart.push_back(extent.first);
+            coveredEnd.push_back(extent.second);
+        }
+    }
+    
+    if (receivers.empty() || !(zMax > zMin)) {
+        // Nothing to index, or a pipe without length: one slab holding every receiver
+        this->zMin = zMin;
+        slabsPerUnit = 0.0;
+        slabCount = 1;
+        slabStart.push_back(0);
+        for (int k = 0; k < receivers.size(); ++k) {
+            slabReceivers.push_back(k);
+        }
+        slabStart.push_back(static_cast<int>(slabReceivers.size()));
+        return;
+    }
+    
+    this->zMin = zMin;
+    slabCount = std::min(MAX_SLABS, SLABS_PER_RECEIVER * static_cast<int>(receivers.size()));
+    slabsPerUnit = slabCount / (zMax - zMin);
+    
+    // First and last slab of every receiver, clamped to the pipe
+    std::vector<int> firstSlab(receivers.size());
+    std::vector<int> lastSlab(receivers.size());
+    for (int k = 0; k < receivers.size(); ++k) {
+        double extentMin, extentMax;
+        receivers[k]->getAxialExtent(extentMin, extentMax);
+        double first = std::floor((extentMin - zMin) * slabsPerUnit);
+        double last = std::floor((extentMax - zMin) * slabsPerUnit);
+        firstSlab[k] = static_cast<int>(std::min(std::max(first, 0.0), double(slabCount - 1)));
+        lastSlab[k] = static_cast<int>(std::min(std::max(last, 0.0), double(slabCount - 1)));
+    }
+    
+    // Count, prefix sum, fill: receivers go in in increasing index order within every slab
+    slabStart.assign(slabCount + 1, 0);
+    for (int k = 0; k < receivers.size(); ++k) {
+        for (int s = firstSlab[k]; s <= lastSlab[k]; ++s) {
+            slabStart[s + 1]++;
+        }
+    }
+    for (int s = 0; s < slabCount; ++s) {
+        slabStart[s + 1] += slabStart[s];
+    }
+    slabReceivers.resize(slabStart[slabCount]);
+    std::vector<int> fill(slabStart.begin(), slabStart.end() - 1);
+    for (int k = 0; k < receivers.size(); ++k) {
+        for (int s = firstSlab[k]; s <= lastSlab[k]; ++s) {
+            slabReceivers[fill[s]++] = k;
+        }
+    }
+}
+
+double ReceiverIndex::clearance(double x, double y, double z, double limit) const
+{
+    if (slabCount == 0) {
+        return limit;
+    }
+    
+    glm::dvec3 point(x, y, z);
+    double nearest = limit;
+    auto scanSlab = [&](int slab) {
+        for (int i = slabStart[slab]; i < slabStart[slab + 1]; ++i) {
+            nearest = std::min(nearest, indexed[slabReceivers[i]]->clearance(point));
+        }
+    };
+    
+    // Walk out from z's slab one slab to each side at a time, until the slabs are further along z than
+    // the nearest receiver found so far
+    int home = static_cast<int>((z - zMin) * slabsPerUnit);
+    home = std::min(std::max(home, 0), slabCount - 1);
+    scanSlab(home);
+    for (int offset = 1; nearest > 0.0; ++offset) {
+        int below = home - offset;
+        int above = home + offset;
+        bool scanned = false;
+        if (below >= 0 && z - (zMin + (below + 1) / slabsPerUnit) < nearest) {
+            scanSlab(below);
+            scanned = true;
+        }
+        if (above < slabCount && zMin + above / slabsPerUnit - z < nearest) {
+            scanSlab(above);
+            scanned = true;
+        }
+        if (!scanned) {
+            break;
+        }
+    }
+    return nearest;
+}
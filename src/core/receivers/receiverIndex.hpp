@@ -0,0 +1,76 @@
+//
+//  receiverIndex.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef receiverIndex_hpp
+#define receiverIndex_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include "receiver.hpp"
+
+// Axial bin index over the receivers of one pipe.
+// The pipe's z range is cut into equal slabs and every slab lists the receivers whose z extent
+// (Receiver::getAxialExtent) overlaps it, so a particle only needs testing against the receivers of its own slab.
+// Receivers without a bounded extent are listed in every slab they can reach.
+// The lists are stored back to back (slabStart[s] .. slabStart[s + 1]) with receiver indices in increasing order.
+class ReceiverIndex
+{
+private:
+    double zMin = 0.0;
+    double slabsPerUnit = 0.0;
+    int slabCount = 0;
+    std::vector<int> slabStart;
+    std::vector<int> slabReceivers;
+    std::vector<const Receiver*> indexed; // the receivers the indices refer to
+    // Union of the receivers' z extents as sorted, disjoint intervals
+    std::vector<double> coveredStart;
+    std::vector<double> coveredEnd;
+
+public:
+    // Indexes the receivers over [zMin, zMax], the pipe's length
+    void build(const std::vector<std::unique_ptr<Receiver>>& receivers, double zMin, double zMax);
+
+    // Points candidates at the indices of the receivers that may hit a particle at z and returns how many there are.
+    // Positions outside [zMin, zMax] use the nearest end slab.
+    int candidates(double z, const int** candidates) const;
+
+    // Distance along z from z to the nearest receiver extent, 0 inside one and infinity without receivers.
+    // No receiver can be hit by a particle that stays closer to z than this.
+    double axialClearance(double z) const;
+
+    // Distance from (x, y, z) to the nearest receiver by Receiver::clearance, looking no further than limit
+    // along z: the result is at most limit.
+    double clearance(double x, double y, double z, double limit) const;
+};
+
+inline int ReceiverIndex::candidates(double z, const int** candidates) const {
+    if (slabCount == 0) {
+        return 0;
+    }
+    int slab = static_cast<int>((z - zMin) * slabsPerUnit);
+    slab = std::min(std::max(slab, 0), slabCount - 1);
+    *candidates = slabReceivers.data() + slabStart[slab];
+    return slabStart[slab + 1] - slabStart[slab];
+}
+
+inline double ReceiverIndex::axialClearance(double z) const {
+    // First interval that ends at or after z: z is either in it or between it and the one before
+    size_t next = std::lower_bound(coveredEnd.begin(), coveredEnd.end(), z) - coveredEnd.begin();
+    double clearance = std::numeric_limits<double>::infinity();
+    if (next < coveredEnd.size()) {
+        clearance = std::max(coveredStart[next] - z, 0.0);
+    }
+    if (next > 0) {
+        clearance = std::min(clearance, z - coveredEnd[next - 1]);
+    }
+    return clearance;
+}
+
+#endif /* receiverIndex_hpp */
@@ -8,3 +8,12 @@
 #include "ringReceiver.hpp"
 
 RingReceiver::RingReceiver(glm::dvec3 position, int countingType, int orientation): Receiver(position, countingType), orientation(orientation) {}
+
+void RingReceiver::hitBatch(const double* x, const double* y, const double* z, int count, uint8_t* mask) const {
+    // A plane compare along the ring's axis
+    const double* axis = orientation == 0 ? x : orientation == 1 ? y : z;
+    double plane = orientation == 0 ? position.x : orientation == 1 ? position.y : position.z;
+    for (int i = 0; i < count; ++i) {
+        mask[i] = (axis[i] > plane);
+    }
+}
@@ -18,6 +18,9 @@ private:
 public:
     RingReceiver(glm::dvec3 position, int countingType, int orientation);
     bool hit(glm::dvec3 particlePosition) const override;
+    void getAxialExtent(double& zMin, double& zMax) const override;
+    double clearance(glm::dvec3 point) const override;
+    void hitBatch(const double* x, const double* y, const double* z, int count, uint8_t* mask) const override;
     int getOrientation() const;
     void setOrientation(int orientation);
 };
@@ -34,6 +37,18 @@ inline bool RingReceiver::hit(glm::dvec3 particlePosition) const {
     return false;
 }
 
+inline void RingReceiver::getAxialExtent(double& zMin, double& zMax) const {
+    Receiver::getAxialExtent(zMin, zMax);
+    if (orientation == 2) {
+        zMin = position.z;
+    }
+}
+
+inline double RingReceiver::clearance(glm::dvec3 point) const {
+    // Distance to the half space beyond the ring's plane
+    return std::max(position[orientation] - point[orientation], 0.0);
+}
+
 inline int RingReceiver::getOrientation() const {
     return orientation;
 }
@@ -9,3 +9,12 @@
 
 RingReceiverWithThickness::RingReceiverWithThickness(glm::dvec3 position, int countingType, int orientation, double thickness): Receiver(position, countingType), orientation(orientation), thickness(thickness) {}
 
+void RingReceiverWithThickness::hitBatch(const double* x, const double* y, const double* z, int count, uint8_t* mask) const {
+    // Between two planes along the ring's axis
+    const double* axis = orientation == 0 ? x : orientation == 1 ? y : z;
+    double plane = orientation == 0 ? position.x : orientation == 1 ? position.y : position.z;
+    double farPlane = plane + thickness;
+    for (int i = 0; i < count; ++i) {
+        mask[i] = (axis[i] > plane) & (axis[i] < farPlane);
+    }
+}
@@ -19,6 +19,9 @@ private:
 public:
     RingReceiverWithThickness(glm::dvec3 position, int countingType, int orientation, double thickness);
     bool hit(glm::dvec3 particlePosition) const override;
+    void getAxialExtent(double& zMin, double& zMax) const override;
+    double clearance(glm::dvec3 point) const override;
+    void hitBatch(const double* x, const double* y, const double* z, int count, uint8_t* mask) const override;
     int getOrientation() const;
     double getThickness() const;
     void setOrientation(int orientation);
@@ -36,6 +39,20 @@ inline bool RingReceiverWithThickness::hit(glm::dvec3 particlePosition) const {
     return false;
 }
 
+inline void RingReceiverWithThickness::getAxialExtent(double& zMin, double& zMax) const {
+    Receiver::getAxialExtent(zMin, zMax);
+    if (orientation == 2) {
+        zMin = position.z;
+        zMax = position.z + thickness;
+    }
+}
+
+inline double RingReceiverWithThickness::clearance(glm::dvec3 point) const {
+    // Distance to the slab between the ring's two planes
+    double start = position[orientation];
+    return std::max(std::max(start - point[orientation], point[orientation] - (start + thickness)), 0.0);
+}
+
 inline int RingReceiverWithThickness::getOrientation() const {
     return orientation;
 }
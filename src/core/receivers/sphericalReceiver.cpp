@@ -8,3 +8,13 @@
 
 SphericalReceiver::SphericalReceiver(glm::dvec3 position, int countingType, double radius)
 : Receiver(position, countingType), radius(radius) {}
+
+void SphericalReceiver::hitBatch(const double* x, const double* y, const double* z, int count, uint8_t* mask) const {
+    double radiusSquared = radius * radius;
+    for (int i = 0; i < count; ++i) {
+        double dx = x[i] - position.x;
+        double dy = y[i] - position.y;
+        double dz = z[i] - position.z;
+        mask[i] = (dx * dx + dy * dy + dz * dz < radiusSquared);
+    }
+}
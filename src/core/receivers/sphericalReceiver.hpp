@@ -18,11 +18,25 @@ private:
 public:
     SphericalReceiver(glm::dvec3 position, int countingType, double radius);
     bool hit(glm::dvec3 particlePosition) const override;
+    void getAxialExtent(double& zMin, double& zMax) const override;
+    double clearance(glm::dvec3 point) const override;
+    void hitBatch(const double* x, const double* y, const double* z, int count, uint8_t* mask) const override;
     double getRadius() const;
 };
 
 inline bool SphericalReceiver::hit(glm::dvec3 particlePosition) const {
-    return glm::length(particlePosition - position) < radius;
+    // Squared distances, no sqrt
+    glm::dvec3 offset = particlePosition - position;
+    return glm::dot(offset, offset) < radius * radius;
+}
+
+inline void SphericalReceiver::getAxialExtent(double& zMin, double& zMax) const {
+    zMin = position.z - radius;
+    zMax = position.z + radius;
+}
+
+inline double SphericalReceiver::clearance(glm::dvec3 point) const {
+    return std::max(glm::length(point - position) - radius, 0.0);
 }
 
 inline double SphericalReceiver::getRadius() const {
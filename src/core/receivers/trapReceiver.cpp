@@ -5,18 +5,51 @@
 //  Created by Dağhan Erdönmez on 31.03.2025.
 //
 
+#define _USE_MATH_DEFINES
 #include "trapReceiver.hpp"
+#include <cmath>
+#include <algorithm>
 
 TrapReceiver::TrapReceiver(glm::dvec3 position, int countingType, double radius, double length, double theta, double deltaTheta, double thickness) :
-Receiver(position, countingType), radius(radius), length(length), theta(theta), deltaTheta(deltaTheta), thickness(thickness) {}
+Receiver(position, countingType), radius(radius), length(length), theta(theta), deltaTheta(deltaTheta), thickness(thickness) {
+    double start = std::max(theta - deltaTheta/2, -M_PI);
+    double end = std::min(theta + deltaTheta/2, M_PI);
+    
+    if (end < start) {
+        sectorKind = SECTOR_NONE;
+    } else if (end - start >= 2 * M_PI) {
+        sectorKind = SECTOR_FULL;
+    } else {
+        sectorKind = (end - start <= M_PI) ? SECTOR_NARROW : SECTOR_WIDE;
+    }
+    sectorStartX = std::cos(start);
+    sectorStartY = std::sin(start);
+    sectorEndX = std::cos(end);
+    sectorEndY = std::sin(end);
+}
 
 bool TrapReceiver::hit(glm::dvec3 particlePosition) const {
-    glm::dvec3 cylParticlePos = cartesianToCylindrical(particlePosition);
-    double rParticle = cylParticlePos.x;
-    double thetaParticle = cylParticlePos.y;
-    double zParticle = cylParticlePos.z;
+    // Cheap rejects first: the z range, then the squared radial distance, the angle last
+    double zParticle = particlePosition.z;
+    if (zParticle < position.z - length/2 || zParticle > position.z + length/2) {
+        return false;
+    }
+    double innerRadius = radius - thickness;
+    double radialSquared = particlePosition.x * particlePosition.x + particlePosition.y * particlePosition.y;
+    if (innerRadius > 0.0 && radialSquared < innerRadius * innerRadius) {
+        return false;
+    }
+    return inSector(particlePosition.x, particlePosition.y);
+}
+
+void TrapReceiver::hitBatch(const double* x, const double* y, const double* z, int count, uint8_t* mask) const {
+    double zMin = position.z - length/2;
+    double zMax = position.z + length/2;
+    double innerRadius = radius - thickness;
+    double innerSquared = innerRadius > 0.0 ? innerRadius * innerRadius : 0.0;
     
-    return (position.z - length/2 <= zParticle & zParticle <= position.z + length/2 &
-            theta - deltaTheta/2 <= thetaParticle & thetaParticle <= theta + deltaTheta/2 &
-            rParticle >= radius-thickness);
+    for (int i = 0; i < count; ++i) {
+        double radialSquared = x[i] * x[i] + y[i] * y[i];
+        mask[i] = (z[i] >= zMin) & (z[i] <= zMax) & (radialSquared >= innerSquared) & inSector(x[i], y[i]);
+    }
 }
@@ -12,6 +12,7 @@
 #include <src/core/receivers/receiver.hpp>
 #include <src/math/coordinateSystemTransformations.hpp>
 #include "glm/glm.hpp"
+#include <cmath>
 
 class TrapReceiver: public Receiver {
 private:
@@ -20,13 +21,51 @@ private:
     double theta;
     double deltaTheta;
     double thickness;
+    
+    // The angular range [theta - deltaTheta/2, theta + deltaTheta/2], cut to atan2's (-pi, pi] like the
+    // original angle compare, as the unit vectors of its two edges. A point is inside a range of at most pi
+    // when it is left of the start edge and right of the end edge, and inside a wider range when it is not
+    // strictly inside the narrow range between the end and the start edge. Only cross products, no atan2.
+    enum SectorKind { SECTOR_NONE, SECTOR_NARROW, SECTOR_WIDE, SECTOR_FULL };
+    SectorKind sectorKind;
+    double sectorStartX, sectorStartY;
+    double sectorEndX, sectorEndY;
+    
+    bool inSector(double x, double y) const;
 public:
     TrapReceiver(glm::dvec3 position, int countingType, double radius, double length, double theta, double deltaTheta, double thickness);
     bool hit(glm::dvec3 particlePosition) const override;
+    void getAxialExtent(double& zMin, double& zMax) const override;
+    double clearance(glm::dvec3 point) const override;
+    void hitBatch(const double* x, const double* y, const double* z, int count, uint8_t* mask) const override;
     double getLength() const;
     double getDeltaTheta() const;
 };
 
+inline bool TrapReceiver::inSector(double x, double y) const {
+    double leftOfStart = sectorStartX * y - sectorStartY * x;
+    double rightOfEnd = x * sectorEndY - y * sectorEndX;
+    switch (sectorKind) {
+        case SECTOR_NARROW: return leftOfStart >= 0.0 && rightOfEnd >= 0.0;
+        case SECTOR_WIDE: return !(leftOfStart < 0.0 && rightOfEnd < 0.0);
+        case SECTOR_FULL: return true;
+        default: return false;
+    }
+}
+
+inline void TrapReceiver::getAxialExtent(double& zMin, double& zMax) const {
+    zMin = position.z - length/2;
+    zMax = position.z + length/2;
+}
+
+inline double TrapReceiver::clearance(glm::dvec3 point) const {
+    // The trap lines the wall, so a point is at least as far from it as from its z range or its inner radius.
+    // The angular range is left out.
+    double axial = std::max(std::abs(point.z - position.z) - length/2, 0.0);
+    double radial = (radius - thickness) - std::sqrt(point.x * point.x + point.y * point.y);
+    return std::max(axial, radial);
+}
+
 inline double TrapReceiver::getLength() const {
     return length;
 }
@@ -10,10 +10,10 @@
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 800;
 
-int singleRunWithoutGraphics()
+int singleRunWithoutGraphics(const SimulationParameters& parameters)
 {
-    Simulation simulation;
-    simulation.iterateSimulation(NUMBER_OF_ITERATIONS, 0);
+    Simulation simulation(PARTICLE_COUNT, SINGLE_CYLINDER_R, SINGLE_CYLINDER_Z, glm::dvec3(SINGLE_FLOW_X, SINGLE_FLOW_Y, SINGLE_FLOW_Z), parameters);
+    simulation.iterateSimulation(parameters.getIterationCount(), 0);
 //    if (OUTPUT_RESULTS) {
 //        const std::vector<std::unique_ptr<Receiver>>& receivers = simulation.getReceivers();
 //        receivers[0].get()->writeOutput();
@@ -22,7 +22,7 @@ int singleRunWithoutGraphics()
     return 0;
 }
 
-int singleRunWithGraphics()
+int singleRunWithGraphics(const SimulationParameters& parameters)
 {
     // Initialize GLFW
     glfwInit();
@@ -118,7 +118,7 @@ int singleRunWithGraphics()
 
     
     //Initialize the simulation
-    Simulation simulation;
+    Simulation simulation(PARTICLE_COUNT, SINGLE_CYLINDER_R, SINGLE_CYLINDER_Z, glm::dvec3(SINGLE_FLOW_X, SINGLE_FLOW_Y, SINGLE_FLOW_Z), parameters);
     
 //    std::vector<glm::vec3> positions = getParticlePositions();
 //    std::vector<Receiver> receivers = getReceivers();
@@ -128,7 +128,7 @@ int singleRunWithGraphics()
 //    std::cout << receiver.getRadius() << std::endl;
     
     // Render loop
-    int totalFrames = NUMBER_OF_ITERATIONS / ITERATIONS_PER_FRAME;
+    int totalFrames = parameters.getIterationCount() / parameters.iterationsPerFrame;
     int currentFrame = 0;
     while (!glfwWindowShouldClose(window) && currentFrame < totalFrames)
     {
@@ -140,7 +140,7 @@ int singleRunWithGraphics()
         glClear(GL_COLOR_BUFFER_BIT);
         
         //Iterate the simulation
-        simulation.iterateSimulation(ITERATIONS_PER_FRAME, currentFrame);
+        simulation.iterateSimulation(parameters.iterationsPerFrame, currentFrame);
         
         //Draw the receiver
         const std::vector<std::unique_ptr<Receiver>>& receivers = simulation.getReceivers();
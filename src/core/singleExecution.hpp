@@ -20,9 +20,10 @@
 #include <vector>
 #include <src/config/config.h>
 #include <src/config/unused/oldconfig.h>
+#include <src/config/simulationParameters.hpp>
 #include <time.h>
 
-int singleRunWithGraphics();
-int singleRunWithoutGraphics();
+int singleRunWithGraphics(const SimulationParameters& parameters);
+int singleRunWithoutGraphics(const SimulationParameters& parameters);
 
 #endif /* singleExecution_hpp */
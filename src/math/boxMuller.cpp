@@ -0,0 +1,390 @@
+//
+//  boxMuller.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "boxMuller.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define BOX_MULLER_X86 1
+#include <immintrin.h>
+#else
+#define BOX_MULLER_X86 0
+#endif
+
+// Every product that feeds a sum is either an explicit fma or exact, so -ffp-contract cannot make the scalar code
+// round differently from the vector code.
+
+namespace {
+
+typedef void (*TransformFunction)(double*, int, double, double);
+
+// log: fdlibm's reduction to m * 2^e with m in [sqrt(2)/2, sqrt(2)), then log(1 + f) = f - f^2/2 + s (f^2/2 + R)
+// with s = f / (2 + f) and R a minimax polynomial in s^2
+const uint64_t EXPONENT_MAGIC = 0x4330000000000000ULL; // 2^52, its low mantissa bits take the biased exponent
+const double EXPONENT_OFFSET = 4503599627370496.0 + 1023.0;
+const uint64_t MANTISSA_MASK = 0x000FFFFFFFFFFFFFULL;
+const uint64_t ONE_BITS = 0x3FF0000000000000ULL;
+const double SQRT2 = 1.41421356237309504880;
+const double LN2_HI = 6.93147180369123816490e-01; // trailing zeros, exact when multiplied by the exponent
+const double LN2_LO = 1.90821492927058770002e-10;
+const double LG1 = 6.666666666666735130e-01;
+const double LG2 = 3.999999999940941908e-01;
+const double LG3 = 2.857142874366239149e-01;
+const double LG4 = 2.222219843214978396e-01;
+const double LG5 = 1.818357216161805012e-01;
+const double LG6 = 1.531383769920937332e-01;
+const double LG7 = 1.479819860511658591e-01;
+
+// sin and cos of 2 pi t: t = q / 4 + r exactly, |r| <= 1/8, then Taylor series of sin(2 pi r) / r and cos(2 pi r)
+// in r^2. The last terms left out are below 1e-16 relative on that range.
+const double SIN1 = 6.283185307179586;
+const double SIN3 = -41.34170224039976;
+const double SIN5 = 81.60524927607506;
+const double SIN7 = -76.70585975306139;
+const double SIN9 = 42.058693944897655;
+const double SIN11 = -15.09464257682299;
+const double SIN13 = 3.819952584848282;
+const double SIN15 = -0.7181223017785006;
+const double COS2 = -19.739208802178716;
+const double COS4 = 64.9393940226683;
+const double COS6 = -85.45681720669373;
+const double COS8 = 60.24464137187666;
+const double COS10 = -26.4262567833744;
+const double COS12 = 7.903536371318469;
+const double COS14 = -1.714390711088672;
+const double COS16 = 0.28200596845579123;
+
+inline double bitsToDouble(uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline uint64_t doubleToBits(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Natural log of u in (0, 1]
+inline double logScalar(double u)
+{
+    uint64_t bits = doubleToBits(u);
+    double exponent = bitsToDouble((bits >> 52) | EXPONENT_MAGIC) - EXPONENT_OFFSET;
+    double m = bitsToDouble((bits & MANTISSA_MASK) | ONE_BITS);
+    if (m > SQRT2) {
+        m = m * 0.5;
+        exponent = exponent + 1.0;
+    }
+    double f = m - 1.0;
+    double s = f / (2.0 + f);
+    double z = s * s;
+    double w = z * z;
+    double odd = z * std::fma(w, std::fma(w, std::fma(w, LG7, LG5), LG3), LG1);
+    double r = std::fma(w, std::fma(w, std::fma(w, LG6, LG4), LG2), odd);
+    double halfF = 0.5 * f;
+    double tail = std::fma(s, std::fma(halfF, f, r), exponent * LN2_LO);
+    return std::fma(exponent, LN2_HI, std::fma(-halfF, f, f) + tail);
+}
+
+// sin and cos of 2 pi t for t in [0, 1)
+inline void sinCosScalar(double t, double& sine, double& cosine)
+{
+    double quadrant = std::floor(std::fma(t, 4.0, 0.5));
+    double r = std::fma(quadrant, -0.25, t);
+    double r2 = r * r;
+    double s = r * std::fma(r2, std::fma(r2, std::fma(r2, std::fma(r2, std::fma(r2, std::fma(r2, std::fma(r2,
+                   SIN15, SIN13), SIN11), SIN9), SIN7), SIN5), SIN3), SIN1);
+    double c = std::fma(r2, std::fma(r2, std::fma(r2, std::fma(r2, std::fma(r2, std::fma(r2, std::fma(r2,
+                   std::fma(r2, COS16, COS14), COS12), COS10), COS8), COS6), COS4), COS2), 1.0);
+
+    // Rotate by quadrant * 90 degrees (quadrant 4 is t close to 1, the same as 0)
+    double q = std::fma(std::floor(quadrant * 0.25), -4.0, quadrant);
+    bool swap = q == 1.0 || q == 3.0;
+    double rotatedCos = swap ? s : c;
+    double rotatedSin = swap ? c : s;
+    cosine = (q == 1.0 || q == 2.0) ? -rotatedCos : rotatedCos;
+    sine = (q >= 2.0) ? -rotatedSin : rotatedSin;
+}
+
+inline void transformScalar(double u1, double u2, double mean, double stddev, double& first, double& second)
+{
+    double radius = std::sqrt(-2.0 * logScalar(1.0 - u1)) * stddev; // 1 - u1 in (0, 1], exact
+    double sine, cosine;
+    sinCosScalar(u2, sine, cosine);
+    first = std::fma(radius, cosine, mean);
+    second = std::fma(radius, sine, mean);
+}
+
+void transformPairsScalar(double* values, int count, double mean, double stddev)
+{
+    for (int i = 0; i + 1 < count; i += 2) {
+        transformScalar(values[i], values[i + 1], mean, stddev, values[i], values[i + 1]);
+    }
+}
+
+#if BOX_MULLER_X86
+
+__attribute__((target("avx2,fma")))
+inline __m256d logAvx2(__m256d u)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    __m256i bits = _mm256_castpd_si256(u);
+    __m256d exponent = _mm256_sub_pd(
+        _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52),
+                                            _mm256_set1_epi64x(static_cast<long long>(EXPONENT_MAGIC)))),
+        _mm256_set1_pd(EXPONENT_OFFSET));
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi64x(static_cast<long long>(MANTISSA_MASK))),
+        _mm256_set1_epi64x(static_cast<long long>(ONE_BITS))));
+    __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(SQRT2), _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+    exponent = _mm256_add_pd(exponent, _mm256_and_pd(big, one));
+
+    __m256d f = _mm256_sub_pd(m, one);
+    __m256d s = _mm256_div_pd(f, _mm256_add_pd(_mm256_set1_pd(2.0), f));
+    __m256d z = _mm256_mul_pd(s, s);
+    __m256d w = _mm256_mul_pd(z, z);
+    __m256d odd = _mm256_mul_pd(z,
+        _mm256_fmadd_pd(w, _mm256_fmadd_pd(w, _mm256_fmadd_pd(w, _mm256_set1_pd(LG7), _mm256_set1_pd(LG5)),
+                                           _mm256_set1_pd(LG3)), _mm256_set1_pd(LG1)));
+    __m256d r = _mm256_fmadd_pd(w,
+        _mm256_fmadd_pd(w, _mm256_fmadd_pd(w, _mm256_set1_pd(LG6), _mm256_set1_pd(LG4)), _mm256_set1_pd(LG2)), odd);
+    __m256d halfF = _mm256_mul_pd(_mm256_set1_pd(0.5), f);
+    __m256d tail = _mm256_fmadd_pd(s, _mm256_fmadd_pd(halfF, f, r), _mm256_mul_pd(exponent, _mm256_set1_pd(LN2_LO)));
+    return _mm256_fmadd_pd(exponent, _mm256_set1_pd(LN2_HI), _mm256_add_pd(_mm256_fnmadd_pd(halfF, f, f), tail));
+}
+
+__attribute__((target("avx2,fma")))
+inline void sinCosAvx2(__m256d t, __m256d& sine, __m256d& cosine)
+{
+    __m256d quadrant = _mm256_floor_pd(_mm256_fmadd_pd(t, _mm256_set1_pd(4.0), _mm256_set1_pd(0.5)));
+    __m256d r = _mm256_fmadd_pd(quadrant, _mm256_set1_pd(-0.25), t);
+    __m256d r2 = _mm256_mul_pd(r, r);
+
+    __m256d ps = _mm256_fmadd_pd(r2, _mm256_set1_pd(SIN15), _mm256_set1_pd(SIN13));
+    ps = _mm256_fmadd_pd(r2, ps, _mm256_set1_pd(SIN11));
+    ps = _mm256_fmadd_pd(r2, ps, _mm256_set1_pd(SIN9));
+    ps = _mm256_fmadd_pd(r2, ps, _mm256_set1_pd(SIN7));
+    ps = _mm256_fmadd_pd(r2, ps, _mm256_set1_pd(SIN5));
+    ps = _mm256_fmadd_pd(r2, ps, _mm256_set1_pd(SIN3));
+    ps = _mm256_fmadd_pd(r2, ps, _mm256_set1_pd(SIN1));
+    __m256d s = _mm256_mul_pd(r, ps);
+
+    __m256d pc = _mm256_fmadd_pd(r2, _mm256_set1_pd(COS16), _mm256_set1_pd(COS14));
+    pc = _mm256_fmadd_pd(r2, pc, _mm256_set1_pd(COS12));
+    pc = _mm256_fmadd_pd(r2, pc, _mm256_set1_pd(COS10));
+    pc = _mm256_fmadd_pd(r2, pc, _mm256_set1_pd(COS8));
+    pc = _mm256_fmadd_pd(r2, pc, _mm256_set1_pd(COS6));
+    pc = _mm256_fmadd_pd(r2, pc, _mm256_set1_pd(COS4));
+    pc = _mm256_fmadd_pd(r2, pc, _mm256_set1_pd(COS2));
+    __m256d c = _mm256_fmadd_pd(r2, pc, _mm256_set1_pd(1.0));
+
+    __m256d q = _mm256_fmadd_pd(_mm256_floor_pd(_mm256_mul_pd(quadrant, _mm256_set1_pd(0.25))),
+                                _mm256_set1_pd(-4.0), quadrant);
+    __m256d isOne = _mm256_cmp_pd(q, _mm256_set1_pd(1.0), _CMP_EQ_OQ);
+    __m256d isTwo = _mm256_cmp_pd(q, _mm256_set1_pd(2.0), _CMP_EQ_OQ);
+    __m256d isThree = _mm256_cmp_pd(q, _mm256_set1_pd(3.0), _CMP_EQ_OQ);
+    __m256d swap = _mm256_or_pd(isOne, isThree);
+    __m256d signBit = _mm256_set1_pd(-0.0);
+    __m256d rotatedCos = _mm256_blendv_pd(c, s, swap);
+    __m256d rotatedSin = _mm256_blendv_pd(s, c, swap);
+    cosine = _mm256_xor_pd(rotatedCos, _mm256_and_pd(_mm256_or_pd(isOne, isTwo), signBit));
+    sine = _mm256_xor_pd(rotatedSin, _mm256_and_pd(_mm256_or_pd(isTwo, isThree), signBit));
+}
+
+__attribute__((target("avx2,fma")))
+void transformPairsAvx2(double* values, int count, double mean, double stddev)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d minusTwo = _mm256_set1_pd(-2.0);
+    const __m256d vMean = _mm256_set1_pd(mean);
+    const __m256d vStddev = _mm256_set1_pd(stddev);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // Pairs 0..3 are interleaved over two registers: unpack gives u1 and u2 of pairs (0, 2, 1, 3)
+        __m256d a = _mm256_loadu_pd(values + i);
+        __m256d b = _mm256_loadu_pd(values + i + 4);
+        __m256d u1 = _mm256_unpacklo_pd(a, b);
+        __m256d u2 = _mm256_unpackhi_pd(a, b);
+
+        __m256d radius = _mm256_mul_pd(_mm256_sqrt_pd(_mm256_mul_pd(minusTwo, logAvx2(_mm256_sub_pd(one, u1)))),
+                                       vStddev);
+        __m256d sine, cosine;
+        sinCosAvx2(u2, sine, cosine);
+        __m256d first = _mm256_fmadd_pd(radius, cosine, vMean);
+        __m256d second = _mm256_fmadd_pd(radius, sine, vMean);
+
+        // ...and the same unpack puts them back in pair order
+        _mm256_storeu_pd(values + i, _mm256_unpacklo_pd(first, second));
+        _mm256_storeu_pd(values + i + 4, _mm256_unpackhi_pd(first, second));
+    }
+
+    _mm256_zeroupper();
+
+    transformPairsScalar(values + i, count - i, mean, stddev);
+}
+
+// The unmasked forms of srli, sqrt and roundscale merge into an _mm512_undefined register, which GCC reports as
+// maybe uninitialized: the zero-masking forms with every lane set do the same from a zeroed one
+const __mmask8 ALL_LANES = 0xFF;
+
+__attribute__((target("avx512f")))
+inline __m512d logAvx512(__m512d u)
+{
+    __m512i bits = _mm512_castpd_si512(u);
+    __m512d exponent = _mm512_sub_pd(
+        _mm512_castsi512_pd(_mm512_or_si512(_mm512_maskz_srli_epi64(ALL_LANES, bits, 52),
+                                            _mm512_set1_epi64(static_cast<long long>(EXPONENT_MAGIC)))),
+        _mm512_set1_pd(EXPONENT_OFFSET));
+    __m512d m = _mm512_castsi512_pd(_mm512_or_si512(
+        _mm512_and_si512(bits, _mm512_set1_epi64(static_cast<long long>(MANTISSA_MASK))),
+        _mm512_set1_epi64(static_cast<long long>(ONE_BITS))));
+    __mmask8 big = _mm512_cmp_pd_mask(m, _mm512_set1_pd(SQRT2), _CMP_GT_OQ);
+    m = _mm512_mask_mul_pd(m, big, m, _mm512_set1_pd(0.5));
+    exponent = _mm512_mask_add_pd(exponent, big, exponent, _mm512_set1_pd(1.0));
+
+    __m512d f = _mm512_sub_pd(m, _mm512_set1_pd(1.0));
+    __m512d s = _mm512_div_pd(f, _mm512_add_pd(_mm512_set1_pd(2.0), f));
+    __m512d z = _mm512_mul_pd(s, s);
+    __m512d w = _mm512_mul_pd(z, z);
+    __m512d odd = _mm512_mul_pd(z,
+        _mm512_fmadd_pd(w, _mm512_fmadd_pd(w, _mm512_fmadd_pd(w, _mm512_set1_pd(LG7), _mm512_set1_pd(LG5)),
+                                           _mm512_set1_pd(LG3)), _mm512_set1_pd(LG1)));
+    __m512d r = _mm512_fmadd_pd(w,
+        _mm512_fmadd_pd(w, _mm512_fmadd_pd(w, _mm512_set1_pd(LG6), _mm512_set1_pd(LG4)), _mm512_set1_pd(LG2)), odd);
+    __m512d halfF = _mm512_mul_pd(_mm512_set1_pd(0.5), f);
+    __m512d tail = _mm512_fmadd_pd(s, _mm512_fmadd_pd(halfF, f, r), _mm512_mul_pd(exponent, _mm512_set1_pd(LN2_LO)));
+    return _mm512_fmadd_pd(exponent, _mm512_set1_pd(LN2_HI), _mm512_add_pd(_mm512_fnmadd_pd(halfF, f, f), tail));
+}
+
+__attribute__((target("avx512f")))
+inline void sinCosAvx512(__m512d t, __m512d& sine, __m512d& cosine)
+{
+    // Rounding mode 1 of roundscale is floor
+    __m512d quadrant = _mm512_maskz_roundscale_pd(ALL_LANES,
+                                                  _mm512_fmadd_pd(t, _mm512_set1_pd(4.0), _mm512_set1_pd(0.5)),
+                                                  _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512d r = _mm512_fmadd_pd(quadrant, _mm512_set1_pd(-0.25), t);
+    __m512d r2 = _mm512_mul_pd(r, r);
+
+    __m512d ps = _mm512_fmadd_pd(r2, _mm512_set1_pd(SIN15), _mm512_set1_pd(SIN13));
+    ps = _mm512_fmadd_pd(r2, ps, _mm512_set1_pd(SIN11));
+    ps = _mm512_fmadd_pd(r2, ps, _mm512_set1_pd(SIN9));
+    ps = _mm512_fmadd_pd(r2, ps, _mm512_set1_pd(SIN7));
+    ps = _mm512_fmadd_pd(r2, ps, _mm512_set1_pd(SIN5));
+    ps = _mm512_fmadd_pd(r2, ps, _mm512_set1_pd(SIN3));
+    ps = _mm512_fmadd_pd(r2, ps, _mm512_set1_pd(SIN1));
+    __m512d s = _mm512_mul_pd(r, ps);
+
+    __m512d pc = _mm512_fmadd_pd(r2, _mm512_set1_pd(COS16), _mm512_set1_pd(COS14));
+    pc = _mm512_fmadd_pd(r2, pc, _mm512_set1_pd(COS12));
+    pc = _mm512_fmadd_pd(r2, pc, _mm512_set1_pd(COS10));
+    pc = _mm512_fmadd_pd(r2, pc, _mm512_set1_pd(COS8));
+    pc = _mm512_fmadd_pd(r2, pc, _mm512_set1_pd(COS6));
+    pc = _mm512_fmadd_pd(r2, pc, _mm512_set1_pd(COS4));
+    pc = _mm512_fmadd_pd(r2, pc, _mm512_set1_pd(COS2));
+    __m512d c = _mm512_fmadd_pd(r2, pc, _mm512_set1_pd(1.0));
+
+    __m512d q = _mm512_fmadd_pd(_mm512_maskz_roundscale_pd(ALL_LANES, _mm512_mul_pd(quadrant, _mm512_set1_pd(0.25)),
+                                                           _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC),
+                                _mm512_set1_pd(-4.0), quadrant);
+    __mmask8 isOne = _mm512_cmp_pd_mask(q, _mm512_set1_pd(1.0), _CMP_EQ_OQ);
+    __mmask8 isTwo = _mm512_cmp_pd_mask(q, _mm512_set1_pd(2.0), _CMP_EQ_OQ);
+    __mmask8 isThree = _mm512_cmp_pd_mask(q, _mm512_set1_pd(3.0), _CMP_EQ_OQ);
+    __mmask8 swap = isOne | isThree;
+    const __m512i signBit = _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL));
+    __m512i rotatedCos = _mm512_castpd_si512(_mm512_mask_blend_pd(swap, c, s));
+    __m512i rotatedSin = _mm512_castpd_si512(_mm512_mask_blend_pd(swap, s, c));
+    cosine = _mm512_castsi512_pd(_mm512_mask_xor_epi64(rotatedCos, isOne | isTwo, rotatedCos, signBit));
+    sine = _mm512_castsi512_pd(_mm512_mask_xor_epi64(rotatedSin, isTwo | isThree, rotatedSin, signBit));
+}
+
+__attribute__((target("avx512f")))
+void transformPairsAvx512(double* values, int count, double mean, double stddev)
+{
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d minusTwo = _mm512_set1_pd(-2.0);
+    const __m512d vMean = _mm512_set1_pd(mean);
+    const __m512d vStddev = _mm512_set1_pd(stddev);
+    const __m512i evenLanes = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+    const __m512i oddLanes = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+    const __m512i lowPairs = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+    const __m512i highPairs = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512d a = _mm512_loadu_pd(values + i);
+        __m512d b = _mm512_loadu_pd(values + i + 8);
+        __m512d u1 = _mm512_permutex2var_pd(a, evenLanes, b);
+        __m512d u2 = _mm512_permutex2var_pd(a, oddLanes, b);
+
+        __m512d radius = _mm512_mul_pd(_mm512_maskz_sqrt_pd(ALL_LANES, _mm512_mul_pd(minusTwo, logAvx512(_mm512_sub_pd(one, u1)))),
+                                       vStddev);
+        __m512d sine, cosine;
+        sinCosAvx512(u2, sine, cosine);
+        __m512d first = _mm512_fmadd_pd(radius, cosine, vMean);
+        __m512d second = _mm512_fmadd_pd(radius, sine, vMean);
+
+        _mm512_storeu_pd(values + i, _mm512_permutex2var_pd(first, lowPairs, second));
+        _mm512_storeu_pd(values + i + 8, _mm512_permutex2var_pd(first, highPairs, second));
+    }
+
+    _mm256_zeroupper();
+
+    transformPairsScalar(values + i, count - i, mean, stddev);
+}
+
+#endif
+
+struct TransformChoice {
+    TransformFunction function;
+    const char* name;
+};
+
+TransformChoice chooseTransform()
+{
+#if BOX_MULLER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return { transformPairsAvx512, "avx512" };
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return { transformPairsAvx2, "avx2" };
+    }
+#endif
+    return { transformPairsScalar, "scalar" };
+}
+
+const TransformChoice& selectedTransform()
+{
+    // Resolved once, on first use
+    static const TransformChoice choice = chooseTransform();
+    return choice;
+}
+
+} // end anonymous namespace
+
+void boxMullerInPlace(double* values, int count, double mean, double stddev)
+{
+    selectedTransform().function(values, count, mean, stddev);
+}
+
+void boxMullerPair(double u1, double u2, double mean, double stddev, double& first, double& second)
+{
+    transformScalar(u1, u2, mean, stddev, first, second);
+}
+
+const char* boxMullerKernelName()
+{
+    return selectedTransform().name;
+}
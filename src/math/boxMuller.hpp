@@ -0,0 +1,29 @@
+//
+//  boxMuller.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef boxMuller_hpp
+#define boxMuller_hpp
+
+#include <stdio.h>
+
+// Box-Muller transform with its own log and sincos instead of libm.
+// The AVX-512, AVX2 and scalar implementations run the same IEEE operations in the same order (explicit fma,
+// correctly rounded sqrt and division, exact range reduction), so a pair of uniforms gives the same two normals
+// whichever implementation or lane handles it, and on every host and standard library.
+
+// Turns count / 2 interleaved pairs (u1, u2) of [0, 1) uniforms in place into
+// stddev * sqrt(-2 log(1 - u1)) * (cos 2 pi u2, sin 2 pi u2) + mean. count must be even.
+// Dispatches at runtime to an AVX-512, AVX2 or scalar implementation, the scalar one also does the tail.
+void boxMullerInPlace(double* values, int count, double mean, double stddev);
+
+// The same transform for a single pair, as computed by the scalar implementation
+void boxMullerPair(double u1, double u2, double mean, double stddev, double& first, double& second);
+
+// Name of the implementation boxMullerInPlace dispatches to ("avx512", "avx2" or "scalar")
+const char* boxMullerKernelName();
+
+#endif /* boxMuller_hpp */
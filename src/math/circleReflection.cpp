@@ -0,0 +1,146 @@
+//
+//  circleReflection.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "circleReflection.hpp"
+#include <cmath>
+#include <cfloat>
+
+namespace {
+
+// Pulls a point that rounding left just outside the circle back in
+inline void clampInside(double& x, double& y, double radius)
+{
+    double distanceSquared = x * x + y * y;
+    if (distanceSquared > radius * radius) {
+        double scale = radius / std::sqrt(distanceSquared) * (1.0 - DBL_EPSILON);
+        x *= scale;
+        y *= scale;
+    }
+}
+
+// First bounce of the move (startX, startY) -> (endX, endY), which must end outside the circle.
+// Writes the wall hit to hitX/hitY and the mirrored end point to endX/endY.
+// Straight-line code with no branches so it vectorizes inside a loop.
+inline void firstBounce(double startX, double startY, double& endX, double& endY,
+                        double& hitX, double& hitY, double radius)
+{
+    double radiusSquared = radius * radius;
+
+    // A start outside the circle (only ever by rounding) is projected onto the wall
+    double startSquared = startX * startX + startY * startY;
+    double startScale = startSquared > radiusSquared ? radius / std::sqrt(startSquared) : 1.0;
+    startX *= startScale;
+    startY *= startScale;
+
+    // |start + t * d|^2 = R^2  ->  a t^2 + 2 b t + c = 0, the exit is the larger root
+    double dx = endX - startX;
+    double dy = endY - startY;
+    double a = dx * dx + dy * dy;
+    double b = startX * dx + startY * dy;
+    double c = std::fmin(startX * startX + startY * startY - radiusSquared, 0.0);
+    double t = (-b + std::sqrt(b * b - a * c)) / std::fmax(a, DBL_MIN);
+
+    hitX = startX + t * dx;
+    hitY = startY + t * dy;
+
+    // Mirror the rest of the move about the wall normal at the hit
+    double nx = hitX / radius;
+    double ny = hitY / radius;
+    double restX = endX - hitX;
+    double restY = endY - hitY;
+    double along = 2.0 * (restX * nx + restY * ny);
+    endX = hitX + restX - along * nx;
+    endY = hitY + restY - along * ny;
+}
+
+// Finishes a move that is still outside after its first bounce, starting over from the wall hit.
+inline void remainingBounces(double hitX, double hitY, double& endX, double& endY, double radius)
+{
+    double vx = endX - hitX;
+    double vy = endY - hitY;
+    double remaining = std::sqrt(vx * vx + vy * vy);
+    double ux = vx / remaining;
+    double uy = vy / remaining;
+
+    // From a point on the wall, going along u, the wall is hit again after a chord of this length
+    double chord = -2.0 * (hitX * ux + hitY * uy);
+    if (!(chord > 0.0)) {
+        // Grazing the wall: the particle stays where it touched
+        endX = hitX;
+        endY = hitY;
+        clampInside(endX, endY, radius);
+        return;
+    }
+
+    // Every chord is the previous one rotated about the centre by the angle between its two wall points
+    double nextX = hitX + chord * ux;
+    double nextY = hitY + chord * uy;
+    double chordAngle = std::atan2(hitX * nextY - hitY * nextX, hitX * nextX + hitY * nextY);
+
+    double fullChords = std::floor(remaining / chord);
+    double angle = fullChords * chordAngle;
+    double cosAngle = std::cos(angle);
+    double sinAngle = std::sin(angle);
+
+    double lastHitX = cosAngle * hitX - sinAngle * hitY;
+    double lastHitY = sinAngle * hitX + cosAngle * hitY;
+    double lastDirectionX = cosAngle * ux - sinAngle * uy;
+    double lastDirectionY = sinAngle * ux + cosAngle * uy;
+    double left = remaining - fullChords * chord;
+
+    endX = lastHitX + left * lastDirectionX;
+    endY = lastHitY + left * lastDirectionY;
+    clampInside(endX, endY, radius);
+}
+
+inline bool outside(double x, double y, double radius)
+{
+    return x * x + y * y > radius * radius;
+}
+
+} // end anonymous namespace
+
+glm::dvec2 reflectInsideCircle(glm::dvec2 start, glm::dvec2 end, double radius)
+{
+    if (!outside(end.x, end.y, radius)) {
+        return end;
+    }
+
+    double hitX, hitY;
+    firstBounce(start.x, start.y, end.x, end.y, hitX, hitY, radius);
+    if (outside(end.x, end.y, radius)) {
+        remainingBounces(hitX, hitY, end.x, end.y, radius);
+    }
+    return end;
+}
+
+void reflectInsideCircleBatch(const double* startX, const double* startY,
+                              double* endX, double* endY,
+                              int count, double radius)
+{
+    const int chunkSize = 64;
+    double hitX[chunkSize];
+    double hitY[chunkSize];
+
+    for (int chunkStart = 0; chunkStart < count; chunkStart += chunkSize) {
+        int chunkCount = count - chunkStart < chunkSize ? count - chunkStart : chunkSize;
+        const double* sx = startX + chunkStart;
+        const double* sy = startY + chunkStart;
+        double* ex = endX + chunkStart;
+        double* ey = endY + chunkStart;
+
+        for (int i = 0; i < chunkCount; ++i) {
+            firstBounce(sx[i], sy[i], ex[i], ey[i], hitX[i], hitY[i], radius);
+        }
+
+        for (int i = 0; i < chunkCount; ++i) {
+            if (outside(ex[i], ey[i], radius)) {
+                remainingBounces(hitX[i], hitY[i], ex[i], ey[i], radius);
+            }
+        }
+    }
+}
@@ -0,0 +1,35 @@
+//
+//  circleReflection.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef circleReflection_hpp
+#define circleReflection_hpp
+
+#include <stdio.h>
+#include <glm/glm.hpp>
+
+// Specular reflection of a straight move inside a circle centred at the origin.
+// The move start -> end is treated as a ray start + t * (end - start), t in [0, 1]: the wall hit comes from
+// the quadratic |start + t * d|^2 = R^2 and the leftover part of the move is mirrored about the wall normal.
+// There are no slopes, so vertical moves are not a special case, and nothing is printed.
+// A move long enough to bounce several times is finished in closed form: after the first hit the particle
+// runs chords of equal length, each one the previous one rotated about the centre by the same angle.
+
+// Returns where a particle moving from start to end ends up after reflecting off the circle of the given radius.
+// start is expected inside the circle (a start slightly outside from rounding is put back on the wall).
+// The result is never outside the circle.
+glm::dvec2 reflectInsideCircle(glm::dvec2 start, glm::dvec2 end, double radius);
+
+// Batch version for structure-of-arrays positions: endX/endY are replaced with the reflected positions.
+// Every entry is expected to end outside the circle. The first bounce, which is all most moves need,
+// is a branch-free loop over the arrays that the compiler can vectorize; only the entries that are still
+// outside after it go through the multi-bounce closed form one by one.
+// Gives the same result as reflectInsideCircle for every entry.
+void reflectInsideCircleBatch(const double* startX, const double* startY,
+                              double* endX, double* endY,
+                              int count, double radius);
+
+#endif /* circleReflection_hpp */
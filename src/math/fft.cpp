@@ -0,0 +1,76 @@
+//
+//  fft.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#define _USE_MATH_DEFINES
+#include "fft.hpp"
+#include <cmath>
+#include <utility>
+#include <stdexcept>
+
+size_t fftSize(size_t n)
+{
+    size_t size = 1;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+void fft(std::vector<std::complex<double>>& data, bool inverse)
+{
+    size_t n = data.size();
+    if (n & (n - 1)) {
+        throw std::runtime_error("fft: size must be a power of two");
+    }
+    
+    // Bit reversal permutation
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    
+    // Butterflies, the twiddles of a stage computed once from the stage's root
+    std::vector<std::complex<double>> twiddles;
+    for (size_t length = 2; length <= n; length <<= 1) {
+        double angle = (inverse ? 2.0 : -2.0) * M_PI / length;
+        size_t half = length / 2;
+        twiddles.resize(half);
+        for (size_t k = 0; k < half; ++k) {
+            twiddles[k] = std::polar(1.0, angle * k);
+        }
+        for (size_t start = 0; start < n; start += length) {
+            for (size_t k = 0; k < half; ++k) {
+                std::complex<double> even = data[start + k];
+                std::complex<double> odd = data[start + k + half] * twiddles[k];
+                data[start + k] = even + odd;
+                data[start + k + half] = even - odd;
+            }
+        }
+    }
+    
+    if (inverse) {
+        for (std::complex<double>& value : data) {
+            value /= double(n);
+        }
+    }
+}
+
+std::vector<std::complex<double>> realSpectrum(const std::vector<double>& signal, size_t size)
+{
+    std::vector<std::complex<double>> spectrum(size);
+    for (size_t i = 0; i < signal.size() && i < size; ++i) {
+        spectrum[i] = signal[i];
+    }
+    fft(spectrum, false);
+    return spectrum;
+}
@@ -0,0 +1,25 @@
+//
+//  fft.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef fft_hpp
+#define fft_hpp
+
+#include <stdio.h>
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+// Smallest power of two that is at least n
+size_t fftSize(size_t n);
+
+// In-place iterative radix-2 FFT, data.size() must be a power of two. The inverse includes the 1/n.
+void fft(std::vector<std::complex<double>>& data, bool inverse);
+
+// Transform of a real signal zero padded to size (a power of two)
+std::vector<std::complex<double>> realSpectrum(const std::vector<double>& signal, size_t size);
+
+#endif /* fft_hpp */
@@ -7,21 +7,18 @@
 
 #define _USE_MATH_DEFINES
 #include "gaussian.hpp"
-#include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
-#include <time.h>
 
 // uses box-muller transformation
 // if u1 and u2 are two uniformly distributed random variables between 0 and 1
 // then the expression z0 below is a standard normal variable
 // weird
-double generateGaussian(double mean, double stddev)
+// The uniforms come from the caller's RandomStream (used to be the global rand())
+// For whole arrays use RandomStream::fillNormal, which keeps both outputs of the transformation
+double generateGaussian(RandomStream& stream, double mean, double stddev)
 {
-    double u1 = rand() / (RAND_MAX + 1.0);
-    double u2 = rand() / (RAND_MAX + 1.0);
-    double z0 = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
-    return z0 * stddev + mean;
+    return stream.nextNormal(mean, stddev);
 }
 
 // int main()
@@ -9,6 +9,8 @@
 #define gaussian_hpp
 
 #include <stdio.h>
-double generateGaussian(double mean, double stddev);
+#include "randomStream.hpp"
+
+double generateGaussian(RandomStream& stream, double mean, double stddev);
 
 #endif /* gaussian_hpp */
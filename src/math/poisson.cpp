@@ -0,0 +1,85 @@
+//
+//  poisson.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "poisson.hpp"
+#include <cmath>
+
+namespace {
+
+// Above this mean inversion walks too many terms of the distribution
+const double INVERSION_LIMIT = 10.0;
+
+// Smallest k >= first with p(first) + ... + p(k) > u, where p is the distribution and pFirst = p(first).
+// Subtracting from u instead of summing up to it keeps the precision when the probabilities are tiny.
+int invert(double u, double mean, int first, double pFirst)
+{
+    int k = first;
+    double p = pFirst;
+    while (u >= p && p > 0.0) {
+        u -= p;
+        k++;
+        p *= mean / k;
+    }
+    return k;
+}
+
+int transformedRejection(RandomStream& stream, double mean)
+{
+    double slam = std::sqrt(mean);
+    double loglam = std::log(mean);
+    double b = 0.931 + 2.53 * slam;
+    double a = -0.059 + 0.02483 * b;
+    double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+    double vr = 0.9277 - 3.6224 / (b - 2.0);
+    
+    while (true) {
+        double u = stream.nextUniform() - 0.5;
+        double v = stream.nextUniform();
+        double us = 0.5 - std::abs(u);
+        double k = std::floor((2.0 * a / us + b) * u + mean + 0.43);
+        if (us >= 0.07 && v <= vr) {
+            return static_cast<int>(k);
+        }
+        if (k < 0.0 || (us < 0.013 && v > us)) {
+            continue;
+        }
+        if (std::log(v) + std::log(invalpha) - std::log(a / (us * us) + b) <= -mean + k * loglam - std::lgamma(k + 1.0)) {
+            return static_cast<int>(k);
+        }
+    }
+}
+
+} // end anonymous namespace
+
+int generatePoisson(RandomStream& stream, double mean)
+{
+    if (!(mean > 0.0)) {
+        return 0;
+    }
+    if (mean < INVERSION_LIMIT) {
+        return invert(stream.nextUniform(), mean, 0, std::exp(-mean));
+    }
+    return transformedRejection(stream, mean);
+}
+
+int generatePositivePoisson(RandomStream& stream, double mean)
+{
+    if (!(mean > 0.0)) {
+        return 1;
+    }
+    if (mean < INVERSION_LIMIT) {
+        // Invert the distribution restricted to k >= 1, which has total probability 1 - e^-mean
+        double u = stream.nextUniform() * -std::expm1(-mean);
+        return invert(u, mean, 1, mean * std::exp(-mean));
+    }
+    // 0 has probability below e^-10 here, so redrawing is cheap
+    int k = 0;
+    while (k == 0) {
+        k = transformedRejection(stream, mean);
+    }
+    return k;
+}
@@ -0,0 +1,21 @@
+//
+//  poisson.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef poisson_hpp
+#define poisson_hpp
+
+#include <stdio.h>
+#include "randomStream.hpp"
+
+// Poisson distributed count with the given mean: inversion for small means, Hörmann's transformed rejection
+// (PTRS, 1993) from 10 on, so the cost does not grow with the mean
+int generatePoisson(RandomStream& stream, double mean);
+
+// Poisson distributed count conditioned on being at least 1, for processes that skip their empty intervals
+int generatePositivePoisson(RandomStream& stream, double mean);
+
+#endif /* poisson_hpp */
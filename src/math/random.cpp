@@ -6,18 +6,13 @@
 //
 #define _USE_MATH_DEFINES
 #include "random.hpp"
+#include <algorithm>
 
 // Function to generate a random point in a circle of radius r
-std::pair<double, double> generatePointInCircle(double r) {
-    // Random number generators
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> angleDist(0, 2 * M_PI);  // θ in [0, 2π)
-    std::uniform_real_distribution<> radiusDist(0, 1);        // For uniform area distribution
-
+std::pair<double, double> generatePointInCircle(RandomStream& stream, double r) {
     // Generate random angle and radius
-    double theta = angleDist(gen);
-    double radius = r * std::sqrt(radiusDist(gen));  // Adjust for uniform distribution over the area
+    double theta = 2 * M_PI * stream.nextUniform();  // θ in [0, 2π)
+    double radius = r * std::sqrt(stream.nextUniform());  // Adjust for uniform distribution over the area
 
     // Convert polar coordinates to Cartesian coordinates
     double x = radius * std::cos(theta);
@@ -25,3 +20,19 @@ std::pair<double, double> generatePointInCircle(double r) {
 
     return {x, y};
 }
+
+void generatePointsInCircle(RandomStream& stream, double r, double* x, double* y, int count) {
+    // An angle and a radius uniform per point, a chunk at a time
+    const int chunkSize = 128;
+    double uniforms[2 * chunkSize];
+    for (int chunkStart = 0; chunkStart < count; chunkStart += chunkSize) {
+        int chunkCount = std::min(chunkSize, count - chunkStart);
+        stream.fillUniform(uniforms, 2 * chunkCount);
+        for (int i = 0; i < chunkCount; ++i) {
+            double theta = 2 * M_PI * uniforms[2 * i];
+            double radius = r * std::sqrt(uniforms[2 * i + 1]);
+            x[chunkStart + i] = radius * std::cos(theta);
+            y[chunkStart + i] = radius * std::sin(theta);
+        }
+    }
+}
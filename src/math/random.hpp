@@ -11,7 +11,11 @@
 #include <stdio.h>
 #include <random>
 #include <utility>
+#include "randomStream.hpp"
 
-std::pair<double, double> generatePointInCircle(double r);
+std::pair<double, double> generatePointInCircle(RandomStream& stream, double r);
+// Batch version: count points into x and y, with the uniforms drawn in whole generator blocks.
+// On a stream that only ever gave out whole points, the points are the same as count generatePointInCircle calls.
+void generatePointsInCircle(RandomStream& stream, double r, double* x, double* y, int count);
 
 #endif /* random_hpp */
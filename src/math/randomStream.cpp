@@ -0,0 +1,135 @@
+//
+//  randomStream.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "randomStream.hpp"
+#include <src/math/boxMuller.hpp>
+#include <random>
+
+namespace {
+
+const uint32_t PHILOX_M0 = 0xD2511F53;
+const uint32_t PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9;
+const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+inline void mulhilo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo) {
+    uint64_t product = static_cast<uint64_t>(a) * b;
+    hi = static_cast<uint32_t>(product >> 32);
+    lo = static_cast<uint32_t>(product);
+}
+
+// Ten rounds of Philox4x32 on the counter (c0..c3) with key (k0, k1), result written to out
+inline void philox4x32(uint64_t position, uint64_t index, const uint32_t key[2], uint32_t out[4]) {
+    uint32_t c0 = static_cast<uint32_t>(index);
+    uint32_t c1 = static_cast<uint32_t>(index >> 32);
+    uint32_t c2 = static_cast<uint32_t>(position);
+    uint32_t c3 = static_cast<uint32_t>(position >> 32);
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+
+    for (int round = 0; round < 10; ++round) {
+        uint32_t hi0, lo0, hi1, lo1;
+        mulhilo(PHILOX_M0, c0, hi0, lo0);
+        mulhilo(PHILOX_M1, c2, hi1, lo1);
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+inline double toUniform(uint32_t high, uint32_t low) {
+    uint64_t bits = (static_cast<uint64_t>(high) << 32) | low;
+    return (bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+} // end anonymous namespace
+
+RandomStream::RandomStream(uint64_t seed, uint64_t streamId) : position(0), index(0), bufferUsed(4) {
+    // Scramble seed and stream id together so neighbouring ids do not give related keys
+    uint64_t mixed = splitmix64(seed ^ splitmix64(streamId));
+    key[0] = static_cast<uint32_t>(mixed);
+    key[1] = static_cast<uint32_t>(mixed >> 32);
+}
+
+void RandomStream::seek(uint64_t newPosition) {
+    position = newPosition;
+    index = 0;
+    bufferUsed = 4;
+}
+
+void RandomStream::refill() {
+    philox4x32(position, index++, key, buffer);
+    bufferUsed = 0;
+}
+
+double RandomStream::nextNormal(double mean, double stddev) {
+    double u1 = nextUniform();
+    double u2 = nextUniform();
+    double first, second;
+    boxMullerPair(u1, u2, mean, stddev, first, second);
+    return first;
+}
+
+void RandomStream::fillUniform(double* out, int count) {
+    // Whole generator blocks give two doubles each, leftovers in the buffer are dropped
+    uint32_t block[4];
+    int i = 0;
+    for (; i + 1 < count; i += 2) {
+        philox4x32(position, index++, key, block);
+        out[i] = toUniform(block[0], block[1]);
+        out[i + 1] = toUniform(block[2], block[3]);
+    }
+    if (i < count) {
+        philox4x32(position, index++, key, block);
+        out[i] = toUniform(block[0], block[1]);
+    }
+    bufferUsed = 4;
+}
+
+void RandomStream::fillNormal(double* out, int count, double mean, double stddev) {
+    // Uniforms first, then the transform in place over the whole array:
+    // keeps the generator loop and the transcendental loop each tight
+    fillUniform(out, count);
+
+    int pairs = count & ~1;
+    boxMullerInPlace(out, pairs, mean, stddev);
+    if (pairs < count) {
+        // Odd count: the last normal needs a second uniform of its own
+        double second;
+        boxMullerPair(out[pairs], nextUniform(), mean, stddev, out[pairs], second);
+    }
+}
+
+uint64_t streamIdFromName(const std::string& name) {
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+uint64_t generateRandomSeed() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
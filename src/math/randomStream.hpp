@@ -0,0 +1,66 @@
+//
+//  randomStream.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef randomStream_hpp
+#define randomStream_hpp
+
+#include <stdio.h>
+#include <cstdint>
+#include <string>
+
+// Counter-based random number stream (Philox4x32-10, Salmon et al. 2011).
+// The output is a pure function of (key, counter): the key comes from the run seed and a stream id,
+// the counter is a 128-bit number split into a 64-bit position chosen with seek() and a 64-bit running index.
+// That makes streams cheap to create, independent from each other and reproducible no matter which thread
+// or in which order they are used. Every pipe and hub owns its own streams, there is no shared generator.
+class RandomStream
+{
+private:
+    uint32_t key[2];
+    uint64_t position; // high half of the counter, set by seek()
+    uint64_t index;    // low half of the counter, incremented once per 4 outputs
+    uint32_t buffer[4];
+    int bufferUsed;
+
+    void refill();
+
+public:
+    RandomStream(uint64_t seed = 0, uint64_t streamId = 0);
+
+    // Jump to the start of an independent sub-sequence. The same position always gives the same numbers.
+    void seek(uint64_t newPosition);
+
+    uint32_t nextUInt32();
+    double nextUniform(); // [0, 1)
+    double nextNormal(double mean = 0.0, double stddev = 1.0);
+
+    // Batch versions: fill whole arrays straight from generator blocks
+    void fillUniform(double* out, int count);
+    // Box-Muller on each pair of uniforms, keeping both the cos and the sin output.
+    // Vectorized, and the same bits on every host and instruction set (see boxMuller.hpp).
+    void fillNormal(double* out, int count, double mean = 0.0, double stddev = 1.0);
+};
+
+// Stable 64-bit id for a named stream (pipe names, hub names...), independent of load order
+uint64_t streamIdFromName(const std::string& name);
+
+// A seed from the operating system, for runs that do not set one
+uint64_t generateRandomSeed();
+
+inline uint32_t RandomStream::nextUInt32() {
+    if (bufferUsed == 4) {
+        refill();
+    }
+    return buffer[bufferUsed++];
+}
+
+inline double RandomStream::nextUniform() {
+    uint64_t bits = (static_cast<uint64_t>(nextUInt32()) << 32) | nextUInt32();
+    return (bits >> 11) * (1.0 / 9007199254740992.0); // 53 random bits
+}
+
+#endif /* randomStream_hpp */
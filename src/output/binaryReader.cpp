@@ -0,0 +1,32 @@
+//
+//  binaryReader.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "binaryReader.hpp"
+
+BinaryReader::BinaryReader(const uint8_t* data, size_t size, const std::string& sourceName)
+    : data(data), size(size), sourceName(sourceName) {}
+
+uint64_t BinaryReader::readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        need(1);
+        uint8_t byte = data[offset++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Malformed varint in " + sourceName);
+}
+
+std::string BinaryReader::readString() {
+    uint64_t length = readVarint();
+    need(length);
+    std::string value(reinterpret_cast<const char*>(data + offset), length);
+    offset += length;
+    return value;
+}
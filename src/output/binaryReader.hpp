@@ -0,0 +1,91 @@
+//
+//  binaryReader.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef binaryReader_hpp
+#define binaryReader_hpp
+
+#include <stdio.h>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// Reads back what BinaryWriter wrote, from bytes already in memory (a loaded or memory-mapped file).
+// Running past the end or a malformed varint throws std::runtime_error naming the source.
+class BinaryReader
+{
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t offset = 0;
+    std::string sourceName; // for the error messages, e.g. "receiver output out/a.rcv"
+    
+    void need(size_t count) const;
+    
+public:
+    BinaryReader(const uint8_t* data, size_t size, const std::string& sourceName);
+    
+    uint64_t readFixed(int byteCount); // little-endian unsigned of 1 to 8 bytes
+    uint8_t readUInt8();
+    uint16_t readUInt16();
+    uint32_t readUInt32();
+    uint64_t readUInt64();
+    double readDouble();
+    uint64_t readVarint();
+    std::string readString();
+    
+    size_t getOffset() const;
+    bool atEnd() const;
+};
+
+inline void BinaryReader::need(size_t count) const {
+    if (count > size - offset) {
+        throw std::runtime_error("Unexpected end of " + sourceName);
+    }
+}
+
+inline uint64_t BinaryReader::readFixed(int byteCount) {
+    need(byteCount);
+    uint64_t value = 0;
+    for (int i = 0; i < byteCount; ++i) {
+        value |= static_cast<uint64_t>(data[offset++]) << (8 * i);
+    }
+    return value;
+}
+
+inline uint8_t BinaryReader::readUInt8() {
+    return static_cast<uint8_t>(readFixed(1));
+}
+
+inline uint16_t BinaryReader::readUInt16() {
+    return static_cast<uint16_t>(readFixed(2));
+}
+
+inline uint32_t BinaryReader::readUInt32() {
+    return static_cast<uint32_t>(readFixed(4));
+}
+
+inline uint64_t BinaryReader::readUInt64() {
+    return readFixed(8);
+}
+
+inline double BinaryReader::readDouble() {
+    uint64_t bits = readFixed(8);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline size_t BinaryReader::getOffset() const {
+    return offset;
+}
+
+inline bool BinaryReader::atEnd() const {
+    return offset == size;
+}
+
+#endif /* binaryReader_hpp */
@@ -0,0 +1,76 @@
+//
+//  binaryWriter.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "binaryWriter.hpp"
+#include <iostream>
+#include <cstring>
+
+BinaryWriter::BinaryWriter(const std::string& filename) : file(filename, std::ios::binary)
+{
+    if (!file) { // Check if the file opened successfully
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+    }
+    buffer.reserve(1 << 16);
+}
+
+BinaryWriter::~BinaryWriter()
+{
+    flush();
+}
+
+void BinaryWriter::flush()
+{
+    if (!buffer.empty() && file) {
+        file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    }
+    buffer.clear();
+}
+
+void BinaryWriter::writeBytes(const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+    if (buffer.size() >= (1 << 16)) {
+        flush();
+    }
+}
+
+void BinaryWriter::writeUInt16(uint16_t value)
+{
+    put(static_cast<uint8_t>(value));
+    put(static_cast<uint8_t>(value >> 8));
+}
+
+void BinaryWriter::writeUInt32(uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        put(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void BinaryWriter::writeUInt64(uint64_t value)
+{
+    for (int i = 0; i < 8; ++i) {
+        put(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void BinaryWriter::writeDouble(double value)
+{
+    // IEEE 754 bits, little-endian like every other field
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        put(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+}
+
+void BinaryWriter::writeString(const std::string& value)
+{
+    writeVarint(value.size());
+    writeBytes(value.data(), value.size());
+}
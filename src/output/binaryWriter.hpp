@@ -0,0 +1,77 @@
+//
+//  binaryWriter.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef binaryWriter_hpp
+#define binaryWriter_hpp
+
+#include <stdio.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Buffered little-endian writer for the binary output files.
+// Values are appended to an in-memory buffer that is flushed to the file whenever it fills up,
+// so writing an output never needs the whole file in memory.
+class BinaryWriter
+{
+private:
+    std::ofstream file;
+    std::vector<uint8_t> buffer;
+    
+    void put(uint8_t byte);
+    
+public:
+    explicit BinaryWriter(const std::string& filename);
+    ~BinaryWriter();
+    
+    bool isOpen() const;
+    
+    void writeBytes(const void* data, size_t size);
+    void writeUInt8(uint8_t value);
+    void writeUInt16(uint16_t value);
+    void writeUInt32(uint32_t value);
+    void writeUInt64(uint64_t value);
+    void writeDouble(double value);
+    // LEB128: 7 bits per byte, small numbers take a single byte
+    void writeVarint(uint64_t value);
+    // Varint length followed by the bytes
+    void writeString(const std::string& value);
+    
+    void flush();
+    // False once opening or any write so far has failed
+    bool isGood() const;
+};
+
+inline bool BinaryWriter::isOpen() const {
+    return file.is_open();
+}
+
+inline bool BinaryWriter::isGood() const {
+    return file.good();
+}
+
+inline void BinaryWriter::put(uint8_t byte) {
+    buffer.push_back(byte);
+    if (buffer.size() >= (1 << 16)) {
+        flush();
+    }
+}
+
+inline void BinaryWriter::writeUInt8(uint8_t value) {
+    put(value);
+}
+
+inline void BinaryWriter::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        put(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    put(static_cast<uint8_t>(value));
+}
+
+#endif /* binaryWriter_hpp */
@@ -0,0 +1,66 @@
+//
+//  mappedFile.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "mappedFile.hpp"
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_POSIX 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#define MAPPED_FILE_POSIX 0
+#endif
+
+MappedFile::MappedFile(const std::string& filename)
+{
+#if MAPPED_FILE_POSIX
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor >= 0) {
+        struct stat status;
+        if (fstat(descriptor, &status) == 0) {
+            size = static_cast<size_t>(status.st_size);
+            open = true;
+            if (size > 0) {
+                void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if (address != MAP_FAILED) {
+                    data = static_cast<const uint8_t*>(address);
+                    mapped = true;
+                } else {
+                    open = false;
+                }
+            }
+        }
+        ::close(descriptor); // the mapping stays valid without the descriptor
+        if (open) {
+            return;
+        }
+    }
+#endif
+    // Not mappable here (or the mapping failed): read the whole file instead
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        size = 0;
+        return;
+    }
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = contents.data();
+    size = contents.size();
+    open = true;
+}
+
+MappedFile::~MappedFile()
+{
+#if MAPPED_FILE_POSIX
+    if (mapped) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+#endif
+}
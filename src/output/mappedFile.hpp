@@ -0,0 +1,51 @@
+//
+//  mappedFile.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef mappedFile_hpp
+#define mappedFile_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Read-only view of a whole file.
+// The file is memory-mapped where the platform allows it (POSIX), so opening costs no copy and pages are
+// only read as they are touched; elsewhere it is read into memory. The view lives as long as the object.
+class MappedFile
+{
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    bool open = false;
+    bool mapped = false;
+    std::vector<uint8_t> contents; // the file when it could not be mapped
+    
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    bool isOpen() const;
+    const uint8_t* getData() const;
+    size_t getSize() const;
+};
+
+inline bool MappedFile::isOpen() const {
+    return open;
+}
+
+inline const uint8_t* MappedFile::getData() const {
+    return data;
+}
+
+inline size_t MappedFile::getSize() const {
+    return size;
+}
+
+#endif /* mappedFile_hpp */
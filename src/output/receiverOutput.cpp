@@ -0,0 +1,100 @@
+//
+//  receiverOutput.cpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#include "receiverOutput.hpp"
+#include <src/output/binaryWriter.hpp>
+#include <src/output/binaryReader.hpp>
+#include <src/output/mappedFile.hpp>
+#include <stdexcept>
+#include <cstring>
+
+namespace {
+
+const char RECEIVER_OUTPUT_MAGIC[4] = { 'M', 'S', 'R', 'C' };
+
+} // end anonymous namespace
+
+std::vector<uint64_t> ReceiverOutput::toDense() const
+{
+    std::vector<uint64_t> dense(header.binCount, 0);
+    for (size_t i = 0; i < bins.size(); ++i) {
+        dense[bins[i]] = counts[i];
+    }
+    return dense;
+}
+
+void writeReceiverOutputBinary(const std::string& filename, const ReceiverOutput& output)
+{
+    BinaryWriter writer(filename);
+    if (!writer.isOpen()) {
+        return;
+    }
+    
+    const ReceiverOutputHeader& header = output.header;
+    writer.writeBytes(RECEIVER_OUTPUT_MAGIC, sizeof(RECEIVER_OUTPUT_MAGIC));
+    writer.writeUInt16(RECEIVER_OUTPUT_VERSION);
+    writer.writeString(header.pipeName);
+    writer.writeString(header.receiverName);
+    writer.writeDouble(header.r);
+    writer.writeDouble(header.z);
+    writer.writeUInt8(header.hasRadius ? 1 : 0);
+    writer.writeDouble(header.radius);
+    writer.writeDouble(header.dt);
+    writer.writeVarint(header.binCount);
+    writer.writeVarint(output.bins.size());
+    
+    uint64_t nextBin = 0; // first bin not covered by a previous gap or count
+    for (size_t i = 0; i < output.bins.size(); ++i) {
+        writer.writeVarint(output.bins[i] - nextBin);
+        writer.writeVarint(output.counts[i]);
+        nextBin = output.bins[i] + 1;
+    }
+}
+
+ReceiverOutput readReceiverOutputBinary(const std::string& filename)
+{
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        throw std::runtime_error("Could not open receiver output " + filename);
+    }
+    BinaryReader reader(file.getData(), file.getSize(), "receiver output " + filename);
+    
+    if (file.getSize() < sizeof(RECEIVER_OUTPUT_MAGIC) || std::memcmp(file.getData(), RECEIVER_OUTPUT_MAGIC, sizeof(RECEIVER_OUTPUT_MAGIC)) != 0) {
+        throw std::runtime_error(filename + " is not a receiver output file");
+    }
+    reader.readFixed(sizeof(RECEIVER_OUTPUT_MAGIC));
+    uint64_t version = reader.readUInt16();
+    if (version != RECEIVER_OUTPUT_VERSION) {
+        throw std::runtime_error("Unsupported receiver output version " + std::to_string(version) + " in " + filename);
+    }
+    
+    ReceiverOutput output;
+    ReceiverOutputHeader& header = output.header;
+    header.pipeName = reader.readString();
+    header.receiverName = reader.readString();
+    header.r = reader.readDouble();
+    header.z = reader.readDouble();
+    header.hasRadius = reader.readUInt8() != 0;
+    header.radius = reader.readDouble();
+    header.dt = reader.readDouble();
+    header.binCount = reader.readVarint();
+    
+    uint64_t nonZeroCount = reader.readVarint();
+    output.bins.reserve(nonZeroCount);
+    output.counts.reserve(nonZeroCount);
+    uint64_t nextBin = 0;
+    for (uint64_t i = 0; i < nonZeroCount; ++i) {
+        uint64_t bin = nextBin + reader.readVarint();
+        if (bin >= header.binCount) {
+            throw std::runtime_error("Bin out of range in receiver output " + filename);
+        }
+        output.bins.push_back(bin);
+        output.counts.push_back(reader.readVarint());
+        nextBin = bin + 1;
+    }
+    return output;
+}
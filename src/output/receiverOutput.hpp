@@ -0,0 +1,61 @@
+//
+//  receiverOutput.hpp
+//  Molecular Simulation
+//
+//  Created by agent on 17.10.2026.
+//
+
+#ifndef receiverOutput_hpp
+#define receiverOutput_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Binary receiver output (.rcv), the compact alternative to the comma separated .txt files.
+// All numbers are little-endian, varints are LEB128.
+//
+//   "MSRC"                      magic
+//   uint16   version            RECEIVER_OUTPUT_VERSION
+//   string   pipe name          varint length + bytes
+//   string   receiver name
+//   double   r, z               cylindrical position of the receiver
+//   uint8    has radius         1 for spherical receivers
+//   double   radius             0 when there is none
+//   double   dt                 seconds per bin
+//   varint   bin count
+//   varint   non-zero bin count
+//   then for every non-zero bin, in order:
+//   varint   gap                zero bins since the previous non-zero bin
+//   varint   count
+//
+// Nearly every bin is zero, so a run of zeros costs nothing and a hit costs two or three bytes.
+// src/output/receiverReader.py reads the same format from Python.
+
+#define RECEIVER_OUTPUT_VERSION 1
+
+struct ReceiverOutputHeader {
+    std::string pipeName;
+    std::string receiverName;
+    double r = 0.0;
+    double z = 0.0;
+    bool hasRadius = false;
+    double radius = 0.0;
+    double dt = 0.0;
+    uint64_t binCount = 0;
+};
+
+struct ReceiverOutput {
+    ReceiverOutputHeader header;
+    std::vector<uint64_t> bins;   // indices of the non-zero bins, increasing
+    std::vector<uint64_t> counts; // count of each of those bins
+    
+    std::vector<uint64_t> toDense() const;
+};
+
+void writeReceiverOutputBinary(const std::string& filename, const ReceiverOutput& output);
+// Throws std::runtime_error if the file cannot be read or is not a receiver output
+ReceiverOutput readReceiverOutputBinary(const std::string& filename);
+
+#endif /* receiverOutput_hpp */
@@ -0,0 +1,99 @@
+"""Reader for the binary receiver outputs (.rcv) written when RECEIVER_OUTPUT_BINARY is on.
+
+The layout is described in src/output/receiverOutput.hpp.
+
+    from receiverReader import read_receiver_output
+    output = read_receiver_output("Output/Outputs/<run>/pipe0/receiver0.rcv")
+    counts = output.dense()  # same numbers as the comma separated .txt output
+"""
+
+import struct
+
+import numpy as np
+
+MAGIC = b"MSRC"
+VERSION = 1
+
+
+class ReceiverOutput:
+    def __init__(self, pipe_name, receiver_name, r, z, radius, dt, bin_count, bins, counts):
+        self.pipe_name = pipe_name
+        self.receiver_name = receiver_name
+        self.r = r
+        self.z = z
+        self.radius = radius  # None for receivers without a radius
+        self.dt = dt  # seconds per bin
+        self.bin_count = bin_count
+        self.bins = bins  # indices of the non-zero bins
+        self.counts = counts  # counts of those bins
+
+    def dense(self):
+        dense = np.zeros(self.bin_count, dtype=np.int64)
+        dense[self.bins] = self.counts
+        return dense
+
+    def times(self):
+        """Start time in seconds of each non-zero bin"""
+        return self.bins * self.dt
+
+
+class _Reader:
+    def __init__(self, data, filename):
+        self.data = data
+        self.offset = 0
+        self.filename = filename
+
+    def take(self, size):
+        if self.offset + size > len(self.data):
+            raise ValueError("Unexpected end of receiver output " + self.filename)
+        chunk = self.data[self.offset:self.offset + size]
+        self.offset += size
+        return chunk
+
+    def unpack(self, fmt):
+        return struct.unpack(fmt, self.take(struct.calcsize(fmt)))[0]
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.take(1)[0]
+            value |= (byte & 0x7F) << shift
+            if not byte & 0x80:
+                return value
+            shift += 7
+
+    def string(self):
+        return self.take(self.varint()).decode("utf-8")
+
+
+def read_receiver_output(filename):
+    with open(filename, "rb") as file:
+        reader = _Reader(file.read(), filename)
+
+    if reader.take(4) != MAGIC:
+        raise ValueError(filename + " is not a receiver output file")
+    version = reader.unpack("<H")
+    if version != VERSION:
+        raise ValueError("Unsupported receiver output version %d in %s" % (version, filename))
+
+    pipe_name = reader.string()
+    receiver_name = reader.string()
+    r = reader.unpack("<d")
+    z = reader.unpack("<d")
+    has_radius = reader.unpack("<B")
+    radius = reader.unpack("<d")
+    dt = reader.unpack("<d")
+    bin_count = reader.varint()
+
+    non_zero_count = reader.varint()
+    bins = np.empty(non_zero_count, dtype=np.int64)
+    counts = np.empty(non_zero_count, dtype=np.int64)
+    next_bin = 0
+    for i in range(non_zero_count):
+        bins[i] = next_bin + reader.varint()
+        counts[i] = reader.varint()
+        next_bin = bins[i] + 1
+
+    return ReceiverOutput(pipe_name, receiver_name, r, z, radius if has_radius else None, dt,
+                          bin_count, bins, counts)